@@ -33,6 +33,8 @@ typedef struct circular_buffer c_buff_t;
  * to parameters: capacity - max number of elements
  * In case of allocation failure, NULL will be returned.
  * In order to avoid memory leaking, the CBuffDestroy function is required in end of use.
+ * With a power of two capacity, positions are found with a mask instead of
+ * a division.
  * Time complexity: O(n)
  *
  * PARAMETERS:
@@ -43,6 +45,27 @@ typedef struct circular_buffer c_buff_t;
  */
 c_buff_t *CBuffCreate(size_t capacity);
 
+/******************************************************************************/
+/* DESCRIPTION:
+ * Function that creates a new Circular Buffer for one writer thread and one
+ * reader thread, with no locks. CBuffWrite may be called only by the writer
+ * and CBuffRead only by the reader, each may call CBuffIsEmpty and
+ * CBuffFreeSpace at any time. What the writer wrote is visible to the reader
+ * once CBuffRead returns it. CBuffIsEmpty is exact for the reader and
+ * CBuffFreeSpace for the writer, the other thread sees a value that may
+ * already be out of date.
+ * In case of allocation failure, NULL will be returned.
+ * In order to avoid memory leaking, the CBuffDestroy function is required in end of use.
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * size_t capacity: max number of elements initial Circular Buffer can hold
+ *
+ * RETURN VALUE:
+ * c_buff_t * : pointer to new Circular Buffer created, NULL if allocation failed.
+ */
+c_buff_t *CBuffCreateSPSC(size_t capacity);
+
 /******************************************************************************/
 /* DESCRIPTION:
  * Function that destroys Circular Buffer specified by pointer. 
@@ -65,8 +88,9 @@ void CBuffDestroy(c_buff_t *cbuff);
  * Function that returns a number of bytes that was read from CBuff. 
  * In case of pointers pointing to invalid cbuff or data, behavior is undefined.
  * If count is bigger then the CBuff data the function will read the current data in the CBuff.
+ * The bytes are copied with at most two memcpy calls.
  *
- * Time complexity: O(1)
+ * Time complexity: O(count)
  *
  * PARAMETERS:
  * c_buff_t *CBuff: pointer to CBuff.
@@ -82,7 +106,8 @@ size_t CBuffRead(c_buff_t *cbuff, void *dest, size_t count);
 /* DESCRIPTION:
  * Function that adds data to the end of a CBuff. 
  * In case of pointers pointing to invalid CBuff or src, behavior is undefined.
- * Time complexity: O(1) 
+ * The bytes are copied with at most two memcpy calls.
+ * Time complexity: O(count) 
  *
  * PARAMETERS:
  * c_buff_t *CBuff: pointer to CBuff.
@@ -0,0 +1,220 @@
+/*******************************************************************************
+*                   DS - CONCURRENT HASH TABLE - HEADER FILE
+*
+* Description: API of a thread safe hash table, sharded by hash.
+* Date: 18.10.2026
+* InfinityLabs OL95
+*******************************************************************************/
+/*--------------------------------- Header Guard -----------------------------*/
+
+#ifndef __ILRD_OL95_CONCURRENT_HASH_TABLE_H__
+#define __ILRD_OL95_CONCURRENT_HASH_TABLE_H__
+
+/*-------------------------- HEADER FILES ------------------------------------*/
+#include <stddef.h> /* size_t */
+
+#include "hash_table.h" /* hash_function_t, is_match_hash_t, hash_action_t */
+
+/*------------------------- TYPEDEF ------------------------------------------*/
+
+typedef struct concurrent_hash_table concurrent_hash_table_t;
+
+/* shards used by ConcurrentHashTableCreate */
+#define CHT_DEFAULT_SHARDS (64)
+
+/* (in .c file:)
+
+The entries are split between n_shards independent hash tables by the hash
+of the data, every shard has its own reader-writer lock. Finds on the same
+shard run in parallel, inserts and removes lock only their shard. Every
+shard sits on its own cache lines, so taking one lock does not slow the
+threads using its neighbours. The hash function is called once per
+operation, its result picks the shard and is passed to the shard's table.
+
+typedef struct cht_shard
+{
+	pthread_rwlock_t lock;
+	hash_table_t *table;
+} cht_shard_t;
+
+struct concurrent_hash_table
+{
+	cht_slot_t *shards;  (cht_shard_t padded to a cache line multiple)
+	size_t n_shards;
+	hash_function_t hash_func;
+};
+
+*/
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that creates a new concurrent hash table with
+ * CHT_DEFAULT_SHARDS shards.
+ * Memory will be specially allocated.
+ * In case of memory allocation failure, NULL will be returned.
+ * In order to avoid memory leaks, the ConcurrentHashTableDestroy function is
+ * requiered at end of use.
+ *
+ * Time complexity: O(table_size)
+ *
+ * PARAMETERS:
+ * size_t table_size - initial size of the whole table, split between the
+ * shards. Every shard grows on its own like a hash_table_t.
+ * hash_function_t hash_func - genrate hash from data.
+ * is_match_hash_t match_func - the function to match data.
+ *
+ * RETURN VALUE:
+ * concurrent_hash_table_t * - pointer to new created table, NULL if memory
+ * allocation failed.
+ */
+concurrent_hash_table_t *ConcurrentHashTableCreate(size_t table_size,
+                     hash_function_t hash_func, is_match_hash_t match_func);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that creates a new concurrent hash table with a specific
+ * number of shards. More shards means less contention between writers,
+ * a few times the number of threads is usually enough.
+ *
+ * Time complexity: O(table_size + n_shards)
+ *
+ * PARAMETERS:
+ * size_t table_size - initial size of the whole table.
+ * size_t n_shards - number of shards, at least one.
+ * hash_function_t hash_func - genrate hash from data.
+ * is_match_hash_t match_func - the function to match data.
+ *
+ * RETURN VALUE:
+ * concurrent_hash_table_t * - pointer to new created table, NULL if memory
+ * allocation failed.
+ */
+concurrent_hash_table_t *ConcurrentHashTableCreateShards(size_t table_size,
+    size_t n_shards, hash_function_t hash_func, is_match_hash_t match_func);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that destroys a specified table.
+ * Previously allocated memory will be freed, the data is not touched.
+ * No other thread may use the table during or after the call.
+ *
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * concurrent_hash_table_t *table - pointer to a table to be destroyed
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void ConcurrentHashTableDestroy(concurrent_hash_table_t *table);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that adds data to the table, same as HashTableInsert.
+ * Locks only the shard of data for writing.
+ *
+ * Time complexity: O(1) amortized
+ *
+ * PARAMETERS:
+ * concurrent_hash_table_t *table - pointer to table to be added to.
+ * void *data - pointer to data to be added.
+ *
+ * RETURN VALUE:
+ * if failed return non zero, else return 0.
+ */
+int ConcurrentHashTableInsert(concurrent_hash_table_t *table, void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes data entry from the table, same as
+ * HashTableRemove. Locks only the shard of data for writing.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * concurrent_hash_table_t *table - pointer to table.
+ * const void *data - data to remove.
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void ConcurrentHashTableRemove(concurrent_hash_table_t *table,
+                               const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the specified data in the table, same as
+ * HashTableFind. Locks only the shard of data for reading, so finds run in
+ * parallel with each other.
+ * The table does not own the data, if another thread may remove the
+ * returned data the caller has to keep it alive by its own means.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const concurrent_hash_table_t *table - pointer to table.
+ * const void *data - pointer to the data that is being searched for.
+ *
+ * RETURN VALUE:
+ * if found returns the data, else returns NULL.
+ */
+void *ConcurrentHashTableFind(const concurrent_hash_table_t *table,
+                              const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns current number of entries. With other threads
+ * inserting or removing, the result is only a snapshot.
+ *
+ * Time complexity: O(n_shards)
+ *
+ * PARAMETERS:
+ * const concurrent_hash_table_t *table - pointer to table.
+ *
+ * RETURN VALUE:
+ * size_t - current number of entries.
+ */
+size_t ConcurrentHashTableSize(const concurrent_hash_table_t *table);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that checks if the table is empty or not.
+ *
+ * Time complexity: O(n_shards)
+ *
+ * PARAMETERS:
+ * const concurrent_hash_table_t *table - pointer to table.
+ *
+ * RETURN VALUE:
+ * int - one if the table is empty, zero if not.
+ */
+int ConcurrentHashTableIsEmpty(const concurrent_hash_table_t *table);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that preforms action on every entry, shard by shard.
+ * Every shard is locked for reading while its entries are visited, so the
+ * action must not insert to or remove from the table.
+ *
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * const concurrent_hash_table_t *table - pointer to table.
+ * hash_action_t hash_action - the action to be preformed
+ * void *param - param to the action function
+ *
+ * RETURN VALUE:
+ * if failed return non zero, else return 0.
+ */
+int ConcurrentHashTableForEach(const concurrent_hash_table_t *table,
+                               hash_action_t hash_action, void *param);
+
+/*----------------------------------------------------------------------------*/
+#endif /* __ILRD_OL95_CONCURRENT_HASH_TABLE_H__ */
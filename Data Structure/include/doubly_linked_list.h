@@ -13,6 +13,8 @@
 /*-------------------------- HEADER FILES ------------------------------------*/
 #include <stddef.h> /* size_t */
 
+#include "fsa.h" /* fsa_pool_t */
+
 /*------------------------- TYPEDEF ------------------------------------------*/
 
  
@@ -22,11 +24,11 @@ typedef struct doubly_linked_list dlist_t;
 
 typedef struct doubly_linked_list_iter dlist_iter_t;
 
-struct doubly_linked_list_iter
-{
-	node_t *internal;
-};
-/* (in .c file:)
+/* a list node. A list made by DListCreate allocates and frees its nodes, a
+list made by DListCreateIntrusive links nodes the caller embeds in its own
+structs (DListInsertNode / DListPushBackNode) and never allocates or frees
+them. data is what DListGetData returns, usually the embedding struct. */
+typedef struct node dlist_node_t;
 
 struct node 
 {
@@ -34,11 +36,21 @@ struct node
 	node_t *next;
 	node_t *prev;
 };
+
+struct doubly_linked_list_iter
+{
+	node_t *internal;
+};
+/* (in .c file:)
+
 struct doubly_linked_list 
 {
 	node_t head;
 	node_t tail;
-	
+	int is_intrusive;
+	fsa_pool_t *pool;
+	int is_pool_owned;
+	size_t size;
 };
 
 */
@@ -77,6 +89,52 @@ dlist_t *DListCreate(void);
 
 /*----------------------------------------------------------------------------*/
 
+/* DESCRIPTION:
+ * A function that creates a new intrusive doubly linked list: the nodes are
+ * owned by the caller, added with DListInsertNode / DListPushBackNode.
+ * DListRemove, DListPopBack and DListDestroy only unlink the nodes, nothing
+ * but the list itself is ever allocated or freed. All other functions work
+ * the same as on a regular list. DListInsert and DListPushBack can not be
+ * used on it, and nodes must not be spliced between the two kinds.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * function does not take any parameters
+ *
+ * RETURN VALUE:
+ * dlist_t * - pointer to new created doubly linked list, NULL if memory
+ * allocation failed.
+ */
+dlist_t *DListCreateIntrusive(void);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that creates a new doubly linked list that takes its nodes from
+ * an fsa pool instead of malloc, so push / pop churn reuses freed nodes and
+ * nodes inserted together sit together in memory. The pool's blocks must be
+ * at least sizeof(dlist_node_t). A pool may be shared by several lists, it
+ * must outlive all of them. Nodes may be spliced only between lists that
+ * use the same pool.
+ * In case of memory allocation failure, NULL will be returned.
+ * In order to avoid memory leaks, the DListDestroy function is required at
+ * end of use.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * fsa_pool_t *pool - the pool of the nodes, NULL for a pool owned by the
+ * list and destroyed with it.
+ *
+ * RETURN VALUE:
+ * dlist_t * - pointer to new created doubly linked list, NULL if memory
+ * allocation failed.
+ */
+dlist_t *DListCreatePooled(fsa_pool_t *pool);
+
+/*----------------------------------------------------------------------------*/
+
 /* DESCRIPTION:
  * A function that destroys a specified doubly linked list . 
  * Previously allocated memory will be freed.
@@ -180,6 +238,63 @@ dlist_iter_t DListRemove(dlist_t *list, dlist_iter_t iterator);
 
 /*----------------------------------------------------------------------------*/
 
+/* DESCRIPTION:
+ * A function that links a caller owned node into an intrusive doubly
+ * linked list before next_iterator. Nothing is allocated, so it can not
+ * fail. The node must not be in a list already.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * dlist_t *list - pointer to a list made by DListCreateIntrusive.
+ * dlist_iter_t next_iterator - a list iterator, before which the node will
+ * be linked.
+ * dlist_node_t *node - the node, usually embedded in the data.
+ * const void *data - the data of the node.
+ *
+ * RETURN VALUE:
+ * dlist_iter_t - iterator of the node.
+ */
+dlist_iter_t DListInsertNode(dlist_t *list, dlist_iter_t next_iterator,
+                             dlist_node_t *node, const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that links a caller owned node at the end of an intrusive
+ * doubly linked list, same as DListInsertNode before DListEnd.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * dlist_t *list - pointer to a list made by DListCreateIntrusive.
+ * dlist_node_t *node - the node, usually embedded in the data.
+ * const void *data - the data of the node.
+ *
+ * RETURN VALUE:
+ * dlist_iter_t - iterator of the node.
+ */
+dlist_iter_t DListPushBackNode(dlist_t *list, dlist_node_t *node,
+                               const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the iterator of a linked node, so a node that is
+ * known (e.g. embedded in the data) can be removed without a search.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * dlist_node_t *node - a node that is linked into a list.
+ *
+ * RETURN VALUE:
+ * dlist_iter_t - iterator of the node.
+ */
+dlist_iter_t DListNodeToIter(dlist_node_t *node);
+
+/*----------------------------------------------------------------------------*/
+
 /* DESCRIPTION:
  * A function that returns an iterator in a doubly linked list that
  * holds specified data.
@@ -231,8 +346,9 @@ dlist_iter_t DListFind
 
 /* DESCRIPTION:
  * A function that returns current number of nodes in a doubly linked list. 
+ * The list keeps the count, nothing is walked.
  *
- * Time complexity: O(n)
+ * Time complexity: O(1)
  *
  * PARAMETERS:
  * dlist_t *list - pointer to a doubly linked list. 
@@ -380,12 +496,17 @@ int DListIsSameIter(dlist_iter_t iterator1, dlist_iter_t iterator2);
 /* DESCRIPTION:
  * A function that splice doubly linked list.
  * The function inserts a list from - to after dest_iter and return th iterator
- * after the to iterator
+ * after the to iterator. The lists are passed so their sizes stay right.
+ * Within a list the nodes are only relinked. Between lists the moved nodes
+ * are walked once to count them, use DListSpliceN when the count is known.
  * 
- * Time complexity: O(1)
+ * Time complexity: O(1) within a list, O(number of moved nodes) between
+ * lists
  *
  * PARAMETERS:
+ * dlist_t *dest_list - the list of dest_iter.
  * dlist_t dest_iter - pointer to the dest
+ * dlist_t *src_list - the list of from and to, may be dest_list.
  * dlist_iter_t from - pointer to the first iterator of a sub-list.
  * dlist_iter_t to - pointer to the last iterator of a sub-list.
  * In case of pointers pointing to invalid dlist, iterator
@@ -394,8 +515,27 @@ int DListIsSameIter(dlist_iter_t iterator1, dlist_iter_t iterator2);
  * RETURN VALUE:
  * dlist_iter_t  the next node of the last node that was added
  */
-dlist_iter_t DListSplice
-              (dlist_iter_t dest_iter, dlist_iter_t from, dlist_iter_t to);
+dlist_iter_t DListSplice(dlist_t *dest_list, dlist_iter_t dest_iter,
+                         dlist_t *src_list, dlist_iter_t from, dlist_iter_t to);
+/*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * Same as DListSplice, the caller passes the number of nodes in from - to
+ * so a move between lists is O(1) as well (e.g. one node, or a whole list
+ * with DListSize). count is ignored within a list.
+ * 
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * same as DListSplice, and
+ * size_t count - the number of nodes in from - to.
+ * (In case of a wrong count the sizes of the lists are wrong)
+ *
+ * RETURN VALUE:
+ * dlist_iter_t  the next node of the last node that was added
+ */
+dlist_iter_t DListSpliceN(dlist_t *dest_list, dlist_iter_t dest_iter,
+                          dlist_t *src_list, dlist_iter_t from,
+                          dlist_iter_t to, size_t count);
 /*----------------------------------------------------------------------------*/
 
 /* DESCRIPTION:
@@ -0,0 +1,94 @@
+/*******************************************************************************
+*                       DS - HASH FUNCTIONS - HEADER FILE
+*
+* Description: General purpose hash functions for the hash tables.
+* Date: 18.10.2026
+* InfinityLabs OL95
+*******************************************************************************/
+/*--------------------------------- Header Guard -----------------------------*/
+
+#ifndef __ILRD_OL95_HASH_FUNCTIONS_H__
+#define __ILRD_OL95_HASH_FUNCTIONS_H__
+
+/*-------------------------- HEADER FILES ------------------------------------*/
+#include <stddef.h> /* size_t */
+
+/*----------------------------------------------------------------------------*/
+
+/* (in .c file:)
+
+HashBytes follows xxHash64: 32 byte stripes are mixed into four independent
+accumulators (so the multiplies of a stripe run in parallel), the tail is
+mixed 8, 4 and 1 bytes at a time, and a final avalanche spreads every input
+bit over the whole result. Words are read in the native byte order, so the
+values differ between little and big endian machines.
+
+HashInt is the 64 bit finalizer of MurmurHash3, a bijection that flips about
+half of the output bits for every input bit.
+
+*/
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that hashes a range of bytes.
+ *
+ * Time complexity: O(len)
+ *
+ * PARAMETERS:
+ * const void *bytes - the bytes to hash, any alignment.
+ * size_t len - number of bytes.
+ * size_t seed - different seeds give unrelated hashes for the same bytes.
+ *
+ * RETURN VALUE:
+ * size_t - the hash.
+ */
+size_t HashBytes(const void *bytes, size_t len, size_t seed);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that mixes an integer key, so keys that differ in a few bits
+ * (sequential ids, aligned addresses) get unrelated hashes.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * size_t key - the key.
+ *
+ * RETURN VALUE:
+ * size_t - the hash.
+ */
+size_t HashInt(size_t key);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * hash_function_t for data that is a null terminated string.
+ *
+ * Time complexity: O(length of the string)
+ *
+ * PARAMETERS:
+ * const void *data - pointer to the first char of the string.
+ *
+ * RETURN VALUE:
+ * size_t - the hash.
+ */
+size_t HashString(const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * hash_function_t for data that points to a size_t key.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const void *data - pointer to the key.
+ *
+ * RETURN VALUE:
+ * size_t - the hash.
+ */
+size_t HashSizeT(const void *data);
+
+/*----------------------------------------------------------------------------*/
+#endif /* __ILRD_OL95_HASH_FUNCTIONS_H__ */
@@ -0,0 +1,183 @@
+/*******************************************************************************
+*                       DS - HASH SNAPSHOT - HEADER FILE
+*
+* Description: API for saving a hash table to a file and looking it up
+*              read only straight from the mapped file.
+* Date: 18.10.2026
+* InfinityLabs OL95
+*******************************************************************************/
+/*--------------------------------- Header Guard -----------------------------*/
+
+#ifndef __ILRD_OL95_HASH_SNAPSHOT_H__
+#define __ILRD_OL95_HASH_SNAPSHOT_H__
+
+/*-------------------------- HEADER FILES ------------------------------------*/
+#include <stddef.h> /* size_t */
+
+#include "hash_table.h" /* hash_table_t, hash_function_t */
+
+/*------------------------- TYPEDEF ------------------------------------------*/
+
+typedef struct hash_snapshot hash_snapshot_t;
+
+/* encode function:
+writes the record of data (key and value) to buf if it is at least the
+needed size, returns the needed size either way. Called with buf NULL and
+buf_size 0 first. */
+typedef size_t (*snap_encode_t)(const void *data, void *buf, size_t buf_size,
+                                void *param);
+
+/* match function:
+returns 1 if the record of len bytes holds key, else 0 */
+typedef int (*snap_is_match_t)(const void *record, size_t len,
+                               const void *key);
+
+/* action function:
+preform an action on a record, a non zero return stops the iteration */
+typedef int (*snap_action_t)(const void *record, size_t len, void *param);
+
+/* (in .c file:)
+
+File layout, every position is an offset from the start of the file so the
+file can be mapped anywhere, and nothing is parsed when it is opened:
+
+	snap_header_t     magic, byte order check, counts and offsets
+	size_t starts[n_buckets + 1]
+	                  entries of bucket b are entries[starts[b]..starts[b+1])
+	snap_entry_t entries[n_entries]
+	                  {hash, offset, len} of every record, by bucket
+	records           the encoded bytes, every record aligned to size_t
+
+The bucket of a hash is its top bits after multiplying by 2^64 / golden
+ratio, like the hash table. Sizes are size_t in the native byte order, a
+snapshot is read on the same kind of machine that wrote it.
+
+struct hash_snapshot
+{
+	const char *base;
+	size_t map_size;
+	const snap_header_t *header;
+	hash_function_t hash_func;
+	snap_is_match_t is_match;
+};
+
+*/
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that writes all entries of a hash table to a snapshot file.
+ * The file is written under a unique temporary name in the directory of
+ * path, synced to disk and renamed over path at the end, so processes that
+ * have the old snapshot open keep a valid mapping and a crash leaves either
+ * the old or the new snapshot.
+ *
+ * Time complexity: O(n + size of the records)
+ *
+ * PARAMETERS:
+ * const hash_table_t *table - the table to save.
+ * const char *path - the snapshot file name.
+ * hash_function_t hash_func - the hash function of the table.
+ * snap_encode_t encode - encodes the data of an entry.
+ * void *param - param to encode.
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if memory allocation or writing failed
+ * (path is not changed then).
+ */
+int HashSnapshotSave(const hash_table_t *table, const char *path,
+                     hash_function_t hash_func, snap_encode_t encode,
+                     void *param);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that maps a snapshot file read only. Only the header is
+ * checked, the file is not parsed, the pages are read when touched and
+ * are shared between all processes that map the file.
+ * In order to avoid memory leaks, the HashSnapshotClose function is
+ * requiered at end of use.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const char *path - the snapshot file name.
+ * hash_function_t hash_func - the hash function the snapshot was saved with,
+ * applied to lookup keys.
+ * snap_is_match_t is_match - matches a record with a lookup key.
+ *
+ * RETURN VALUE:
+ * hash_snapshot_t * - the opened snapshot, NULL if the file can not be
+ * mapped or is not a snapshot of this kind of machine.
+ */
+hash_snapshot_t *HashSnapshotOpen(const char *path, hash_function_t hash_func,
+                                  snap_is_match_t is_match);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that unmaps a snapshot. Records returned by HashSnapshotFind
+ * are not valid after it.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * hash_snapshot_t *snap - the snapshot to close.
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void HashSnapshotClose(hash_snapshot_t *snap);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that finds the record of key in the snapshot.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const hash_snapshot_t *snap - the snapshot.
+ * const void *key - the key, passed to hash_func and is_match.
+ * size_t *len - set to the length of the record if found, can be NULL.
+ *
+ * RETURN VALUE:
+ * const void * - the record inside the mapped file, NULL if not found.
+ */
+const void *HashSnapshotFind(const hash_snapshot_t *snap, const void *key,
+                             size_t *len);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the number of records in the snapshot.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const hash_snapshot_t *snap - the snapshot.
+ *
+ * RETURN VALUE:
+ * size_t - number of records.
+ */
+size_t HashSnapshotSize(const hash_snapshot_t *snap);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that preforms action on every record, in bucket order.
+ *
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * const hash_snapshot_t *snap - the snapshot.
+ * snap_action_t action - the action to be preformed.
+ * void *param - param to the action function.
+ *
+ * RETURN VALUE:
+ * int - the first non zero value returned by action, else 0.
+ */
+int HashSnapshotForEach(const hash_snapshot_t *snap, snap_action_t action,
+                        void *param);
+
+/*----------------------------------------------------------------------------*/
+#endif /* __ILRD_OL95_HASH_SNAPSHOT_H__ */
@@ -17,7 +17,8 @@
 typedef struct hash_table hash_table_t;
 
 /* hash function:
-genrate index for givin data*/
+genrate hash for givin data, the table picks the bucket from the hash.
+hash_functions.h has ready ones for strings, bytes and integer keys */
 typedef size_t (*hash_function_t)(const void *data);
 
 /* match function:
@@ -28,11 +29,80 @@ typedef int (*is_match_hash_t)(const void *hash_data, const void *input_data);
 preform an action on data*/
 typedef int (*hash_action_t)(void *data, void *param);
 
+/* the storage used by the hash table:
+ * HASH_CHAINING - array of doubly linked lists, a list node is allocated
+ *   for every entry.
+ * HASH_OPEN_ADDRESSING - one array of data pointers with a probe byte per
+ *   slot (Robin Hood hashing, see rh_table.h), no allocation per entry. */
+typedef enum hash_backend
+{
+	HASH_CHAINING = 0,
+	HASH_OPEN_ADDRESSING
+} hash_backend_t;
+
+/* backend used by HashTableCreate, can be overridden when building the
+ * library (e.g. -DHASH_DEFAULT_BACKEND=HASH_OPEN_ADDRESSING). An insert to a
+ * chaining table fails only when malloc does, callers that want open
+ * addressing ask for it with HashTableCreateBackend. */
+#ifndef HASH_DEFAULT_BACKEND
+#define HASH_DEFAULT_BACKEND HASH_CHAINING
+#endif
+
+/* number of bins in the hash_stats_t histogram */
+#define HASH_STATS_BINS (8)
+
+/* bucket occupancy of a hash table, filled by HashTableStats.
+ * HASH_CHAINING: hist[i] is the number of buckets that hold i entries.
+ * HASH_OPEN_ADDRESSING: a slot holds one entry, hist[i] is the number of
+ * entries that probed i slots past their home slot.
+ * The last bin also counts everything above it. While the table grows the
+ * buckets of both arrays are counted. */
+typedef struct hash_stats
+{
+	size_t size;
+	size_t buckets;
+	size_t used_buckets;
+	size_t max_len;
+	size_t hist[HASH_STATS_BINS];
+} hash_stats_t;
+
+/* in c file
+
+chaining: the bucket lists are intrusive, every entry {node, hash, data}
+is one allocation that holds its own list node. The stored hash is
+compared before match_func, so match_func is called only on real hash
+collisions and growing does not call hash_func. A bucket is NULL until an
+entry lands in it. When the load passes max_load the buckets array
+doubles, the buckets of old_arr are moved to arr a few per insert / remove
+(cursor is the next one to move), lookups check both arrays meanwhile.
+The number of buckets is a power of two and the bucket of a hash is the top
+bits of hash * golden ratio, no division per operation.
+
+struct hash_table
+{
+    hash_backend_t backend;
+    dlist_t **arr;
+    dlist_t **old_arr;
+    rh_table_t *rh_table;
+    hash_function_t hash_func;
+    is_match_t match_func;
+    size_t table_size;
+    size_t old_size;
+    size_t shift;
+    size_t old_shift;
+    size_t cursor;
+    size_t size;
+    size_t used_buckets;
+    double max_load;
+};
+
+*/
+
 
 /*----------------------------------------------------------------------------*/
 
 /* DESCRIPTION:
- * A function that creates a new hash table.
+ * A function that creates a new hash table using HASH_DEFAULT_BACKEND.
  * Memory will be specially allocated.
  * In case of memory allocation failure, NULL will be returned.
  * In order to avoid memory leaks, the hash_tableDestroy function is requiered at
@@ -54,6 +124,30 @@ hash_table_t *HashTableCreate(size_t table_size, hash_function_t hash_func, is_m
 
 /*----------------------------------------------------------------------------*/
 
+/* DESCRIPTION:
+ * A function that creates a new hash table with a specific backend.
+ * table_size is the initial number of buckets (HASH_CHAINING) or slots
+ * (HASH_OPEN_ADDRESSING), rounded up to a power of two. The table doubles
+ * when the load passes the max load, 1 entry per bucket for chaining and
+ * 7/8 full for open addressing unless set by HashTableSetMaxLoad.
+ * All other hash table functions behave the same with both backends.
+ *
+ * Time complexity: O(table_size)
+ *
+ * PARAMETERS:
+ * size_t table_size - the hash table array size.
+ * hash_function_t hash_func - genrate indexes from data.
+ * is_match_t match_func - the function to match data.
+ * hash_backend_t backend - HASH_CHAINING or HASH_OPEN_ADDRESSING
+ *
+ * RETURN VALUE:
+ * hash_table_t *hash_table - pointer to new created hash table, NULL if memory
+ * allocation failed.
+ */
+hash_table_t *HashTableCreateBackend(size_t table_size, hash_function_t hash_func, is_match_hash_t match_func, hash_backend_t backend);
+
+/*----------------------------------------------------------------------------*/
+
 /* DESCRIPTION:
  * A function that destroys a specified hash table . 
  * Previously allocated memory will be freed.
@@ -76,9 +170,14 @@ void HashTableDestroy(hash_table_t *hash_table);
 /* DESCRIPTION:
  * A function that creates a new hash table entry that holds specified data 
  * and adds it to the hash table. 
- * Memory will be allocated for new hash table entry.
+ * Memory will be allocated for new hash table entry (HASH_CHAINING).
+ * When the load passes the max load the table starts to grow, the entries
+ * are moved to the bigger array a few buckets at a time by the following
+ * inserts and removes, so no single insert rehashes the whole table.
+ * If there is no memory to grow, HASH_CHAINING keeps inserting into the
+ * current buckets.
  *
- * Time complexity: O(1)
+ * Time complexity: O(1) amortized
  *
  * PARAMETERS:
  * hash_table_t *hash_table -	pointer to hash table to be added to. 
@@ -132,10 +231,53 @@ void *HashTableFind(const hash_table_t *hash_table, const void *data);
 
 /*----------------------------------------------------------------------------*/
 
+/* DESCRIPTION:
+ * A function that looks up n keys at once, out[i] is set to what
+ * HashTableFind(hash_table, keys[i]) would return.
+ * The hashes of a group of keys are computed and their buckets prefetched
+ * before any of them is searched, so on tables bigger than the cache the
+ * memory misses of the group overlap instead of following each other.
+ * 
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * const hash_table_t *hash_table - pointer to hash table to be searched in.
+ * const void *const *keys - the n keys to search for.
+ * void **out - array of n results, NULL for a key that is not found.
+ * size_t n - number of keys.
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void HashTableFindBatch(const hash_table_t *hash_table, const void *const *keys, void **out, size_t n);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * Functions like HashTableInsert, HashTableRemove and HashTableFind that
+ * take the hash of data instead of calling hash_func, for a caller that
+ * already computed it (e.g. to pick a shard). hash must be hash_func(data).
+ *
+ * Time complexity: as HashTableInsert, HashTableRemove and HashTableFind
+ *
+ * PARAMETERS:
+ * hash_table_t *hash_table - pointer to hash table.
+ * void *data - pointer to data to be added / searched for.
+ * size_t hash - hash_func(data).
+ *
+ * RETURN VALUE:
+ * as HashTableInsert, HashTableRemove and HashTableFind
+ */
+int HashTableInsertHashed(hash_table_t *hash_table, void *data, size_t hash);
+void HashTableRemoveHashed(hash_table_t *hash_table, const void *data, size_t hash);
+void *HashTableFindHashed(const hash_table_t *hash_table, const void *data, size_t hash);
+
+/*----------------------------------------------------------------------------*/
+
 /* DESCRIPTION:
  * A function that returns current number of entries in a hash_table. 
  *
- * Time complexity: O(n)
+ * Time complexity: O(1)
  *
  * PARAMETERS:
  * hash_table_t *hash_table - pointer to a hash_table. 
@@ -184,15 +326,53 @@ int HashTableIsEmpty(const hash_table_t *hash_table);
 
 int HashTableForEach(const hash_table_t *hash_table, hash_action_t hash_action, void *param);
 
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that sets the load (entries / buckets) above which the table
+ * grows. The default is 1 for HASH_CHAINING and 0.875 for
+ * HASH_OPEN_ADDRESSING, where values above 0.95 are taken as 0.95.
+ * Takes effect from the next insert.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * hash_table_t *hash_table - pointer to a hash_table.
+ * double max_load - the new max load, greater than zero.
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void HashTableSetMaxLoad(hash_table_t *hash_table, double max_load);
 
 /*Advanced*/
 /* for noami and yoni :) */
 /*size/hashtablesize*/
+/* SD - of the chain lengths, of the probe lengths with open addressing */
 
 double HashTableLoad(const hash_table_t *hash_table);
 
 double HashTableSD(const hash_table_t *hash_table);
 
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that fills stats with the occupancy of the table, for tuning
+ * the hash function: number of entries, buckets (slots), non empty buckets,
+ * the longest chain (probe) and the chain (probe) length histogram.
+ * Cheaper than HashTableSD, no floating point math.
+ *
+ * Time complexity: O(table_size + n) chaining, O(table_size) open addressing
+ *
+ * PARAMETERS:
+ * const hash_table_t *hash_table - pointer to a hash_table.
+ * hash_stats_t *stats - filled by the function.
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void HashTableStats(const hash_table_t *hash_table, hash_stats_t *stats);
+
 
 
 /*----------------------------------------------------------------------------*/
@@ -0,0 +1,292 @@
+/*******************************************************************************
+*                             DS - HEAP - HEADER FILE
+*
+* Description: API of array based binary heap functions.
+* Date: 18.10.2026
+* InfinityLabs OL95
+*******************************************************************************/
+/*--------------------------------- Header Guard -----------------------------*/
+
+#ifndef __ILRD_OL95_HEAP_H__
+#define __ILRD_OL95_HEAP_H__
+
+/*-------------------------- HEADER FILES ------------------------------------*/
+#include <stddef.h> /* size_t */
+
+/*------------------------- TYPEDEF ------------------------------------------*/
+
+typedef struct heap heap_t;
+
+/* pointer to a comparison function (same contract as the pq compare):
+ * returns an integer greater than zero if new_data has a higher priority than
+ * existing_data, zero if equal and less than zero if lower.
+ * Elements with equal priority are popped in insertion order (FIFO). */
+typedef int (*heap_cmp_t)(const void *new_data, const void *existing_data);
+
+/* match function:
+returns 1 if match, else 0*/
+typedef int (*heap_is_match_t)(const void *data, const void *param);
+
+/* index function:
+called whenever data moves inside the heap with its new position, and with
+HEAP_NO_INDEX when data leaves the heap */
+typedef void (*heap_set_index_t)(void *data, size_t index);
+
+#define HEAP_NO_INDEX ((size_t)-1)
+
+/* (in .c file:)
+
+typedef struct heap_entry
+{
+	void *data;
+	size_t seq;
+} heap_entry_t;
+
+struct heap
+{
+	heap_entry_t *arr;
+	size_t size;
+	size_t capacity;
+	size_t next_seq;
+	heap_cmp_t cmp;
+	heap_set_index_t set_index;
+};
+
+*/
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that creates a new heap.
+ * Memory will be specially allocated.
+ * In case of memory allocation failure, NULL will be returned.
+ * In order to avoid memory leaks, the HeapDestroy function is requiered at
+ * end of use.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * heap_cmp_t cmp - the users compare function
+ *
+ * RETURN VALUE:
+ * heap_t * - pointer to new created heap, NULL if memory allocation failed.
+ */
+heap_t *HeapCreate(heap_cmp_t cmp);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that creates a new addressable heap.
+ * set_index is called every time an element changes its position, so the
+ * user can keep the current index of each element and later pass it to
+ * HeapRemoveAt / HeapUpdateAt.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * heap_cmp_t cmp - the users compare function
+ * heap_set_index_t set_index - the users index function
+ *
+ * RETURN VALUE:
+ * heap_t * - pointer to new created heap, NULL if memory allocation failed.
+ */
+heap_t *HeapCreateIndexed(heap_cmp_t cmp, heap_set_index_t set_index);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that destroys a specified heap.
+ * Previously allocated memory will be freed.
+ * All remaining data will be lost
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * heap_t *heap - pointer to a heap to be destroyed
+ *
+ * (In case of pointer pointing to invalid heap, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void HeapDestroy(heap_t *heap);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that adds data to the heap considering its priority.
+ * The underlying array grows by doubling when full.
+ *
+ * Time complexity: O(log n) amortized
+ *
+ * PARAMETERS:
+ * heap_t *heap - pointer to heap to be added to.
+ * const void *data - pointer to data to be added.
+ *
+ * (In case of pointers pointing to invalid heap or data, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if memory allocation failed.
+ */
+int HeapPush(heap_t *heap, const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that adds n elements to the heap at once.
+ * The array grows once for the whole batch, and when the batch is at least
+ * as large as the heap it is rebuilt bottom up instead of n separate pushes.
+ * Elements with equal priority keep the order of the batch (FIFO).
+ * Either all elements are added or none.
+ *
+ * Time complexity: O(size + n) when n >= size, O(n log size) otherwise
+ *
+ * PARAMETERS:
+ * heap_t *heap - pointer to heap to be added to.
+ * void *const *data - array of n pointers to data to be added.
+ * size_t n - number of elements.
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if memory allocation failed.
+ */
+int HeapPushMany(heap_t *heap, void *const *data, size_t n);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes the element with the highest priority.
+ *
+ * Time complexity: O(log n)
+ *
+ * PARAMETERS:
+ * heap_t *heap - pointer to heap.
+ *
+ * (In case of pointer pointing to invalid or empty heap, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * void * - pointer to the data that was removed.
+ */
+void *HeapPop(heap_t *heap);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the element with the highest priority.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const heap_t *heap - pointer to heap.
+ *
+ * (In case of pointer pointing to invalid heap, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * void * - pointer to the data on top of the heap, NULL if heap is empty.
+ */
+void *HeapPeek(const heap_t *heap);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes the first element that matches param.
+ *
+ * Time complexity: O(n) for the search, O(log n) for the removal
+ *
+ * PARAMETERS:
+ * heap_t *heap - pointer to heap.
+ * heap_is_match_t is_match - called as is_match(data_in_heap, param).
+ * const void *param - parameter for is_match.
+ *
+ * (In case of pointer pointing to invalid heap, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * void * - pointer to the removed data, NULL if no element matched.
+ */
+void *HeapRemove(heap_t *heap, heap_is_match_t is_match, const void *param);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes the element in a specific position.
+ *
+ * Time complexity: O(log n)
+ *
+ * PARAMETERS:
+ * heap_t *heap - pointer to heap.
+ * size_t index - position of the element, as reported by set_index.
+ *
+ * (In case of index out of range, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * void * - pointer to the removed data.
+ */
+void *HeapRemoveAt(heap_t *heap, size_t index);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that restores the heap order after the priority of the element
+ * in a specific position was changed by the user (increase / decrease key).
+ * The element is ordered as if it was pushed again, so it is placed after
+ * elements that already have the same priority.
+ *
+ * Time complexity: O(log n)
+ *
+ * PARAMETERS:
+ * heap_t *heap - pointer to heap.
+ * size_t index - position of the element, as reported by set_index.
+ *
+ * (In case of index out of range, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * no return value.
+ */
+void HeapUpdateAt(heap_t *heap, size_t index);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns current number of elements in a heap.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const heap_t *heap - pointer to heap.
+ *
+ * RETURN VALUE:
+ * size_t - current number of elements in a heap.
+ */
+size_t HeapSize(const heap_t *heap);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that checks if a heap is empty or not.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const heap_t *heap - pointer to heap.
+ *
+ * RETURN VALUE:
+ * int - one if heap is empty, zero if heap is not empty.
+ */
+int HeapIsEmpty(const heap_t *heap);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes all elements from a heap.
+ * The allocated array is kept for reuse.
+ *
+ * Time complexity: O(1), O(n) for an addressable heap
+ *
+ * PARAMETERS:
+ * heap_t *heap - pointer to heap.
+ *
+ * RETURN VALUE:
+ * no return value.
+ */
+void HeapClear(heap_t *heap);
+
+/*----------------------------------------------------------------------------*/
+#endif /* __ILRD_OL95_HEAP_H__ */
@@ -14,24 +14,50 @@
 /*-------------------------- HEADER FILES ------------------------------------*/
 #include <stddef.h> /* size_t */
 #include "sorted_list.h" /* sl functions declaration */
+#include "heap.h" /* heap functions declaration */
 /*------------------------- TYPEDEF ------------------------------------------*/
  
 typedef struct pq pq_t;
 
+/* the storage used by the pq:
+ * PQ_SORTED_LIST - sorted doubly linked list, O(n) enqueue, O(1) dequeue.
+ * PQ_HEAP - array based binary heap, O(log n) enqueue and dequeue. */
+typedef enum pq_backend
+{
+	PQ_SORTED_LIST = 0,
+	PQ_HEAP
+} pq_backend_t;
+
+/* backend used by PQCreate, can be overridden when building the library
+ * (e.g. -DPQ_DEFAULT_BACKEND=PQ_SORTED_LIST) */
+#ifndef PQ_DEFAULT_BACKEND
+#define PQ_DEFAULT_BACKEND PQ_HEAP
+#endif
+
+/* index function of an addressable pq:
+ * called with the current position of data whenever it moves inside the pq,
+ * and with PQ_NO_INDEX when data leaves the pq */
+typedef void (*pq_set_index_t)(void *data, size_t index);
+
+#define PQ_NO_INDEX HEAP_NO_INDEX
+
 /* in c file
 
 	**The highest priorty will be in the tail**
 
 #include "sorted_list.h"
+#include "heap.h"
 struct pq
 {
+	pq_backend_t backend;
 	sorted_list_t *sorted_list;
+	heap_t *heap;
 };
 
 */
 
 /* DESCRIPTION:
- * A function that creates a new priority pq.
+ * A function that creates a new priority pq using PQ_DEFAULT_BACKEND.
  * Memory will be specially allocated.
  * In case of memory allocation failure, NULL will be returned.
  * In order to avoid memory leaks, the PQueueDestroy function is required at
@@ -49,6 +75,43 @@ struct pq
  */ 
  
 pq_t *PQCreate(int (*cmp)( const void *new_data, const void *existing_data));
+
+/* DESCRIPTION:
+ * A function that creates a new priority pq with a specific backend.
+ * Elements with equal priority are dequeued in insertion order with both
+ * backends.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * cmp - the users compare function
+ * pq_backend_t backend - PQ_SORTED_LIST or PQ_HEAP
+ * RETURN VALUE:
+ * pq_t * - pointer to new created pq, NULL if memory
+ * allocation failed.
+ */ 
+
+pq_t *PQCreateBackend(int (*cmp)(const void *new_data, const void *existing_data),
+                      pq_backend_t backend);
+
+/* DESCRIPTION:
+ * A function that creates a new addressable priority pq (always PQ_HEAP).
+ * The pq reports the position of every element through set_index, the user
+ * keeps it (usually inside the element) and passes it to PQEraseAt and
+ * PQUpdateAt.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * cmp - the users compare function
+ * set_index - the users index function
+ * RETURN VALUE:
+ * pq_t * - pointer to new created pq, NULL if memory
+ * allocation failed.
+ */ 
+
+pq_t *PQCreateAddressable(int (*cmp)(const void *new_data, const void *existing_data),
+                          pq_set_index_t set_index);
  
 /* DESCRIPTION:
  * A function that destroys a specified priority pq . 
@@ -75,7 +138,7 @@ void PQDestroy(pq_t *pq);
  * and adds it to the pq considering its priority. 
  * Memory will be allocated for new pq element.
  *
- * Time complexity: O(n) 
+ * Time complexity: O(n) sorted list, O(log n) amortized heap
  *
  * PARAMETERS:
  * pq_t *pq -	pointer to pq to be added to. 
@@ -88,12 +151,33 @@ void PQDestroy(pq_t *pq);
  */
 int PQEnqueue(pq_t *pq, const void *data);
 
+/* DESCRIPTION:
+ * A function that adds n elements to the pq at once.
+ * With the heap backend the batch is built in one pass (see HeapPushMany),
+ * with the sorted list it is the same as n calls to PQEnqueue.
+ * Either all elements are added or none.
+ *
+ * Time complexity: O(n * size) sorted list, O(size + n) heap when the batch
+ * is at least as large as the pq, O(n log size) heap otherwise
+ *
+ * PARAMETERS:
+ * pq_t *pq -	pointer to pq to be added to. 
+ * void *const *data - array of n pointers to data to be added.
+ * size_t n - number of elements.
+ *
+ *(In case of pointers pointing to invalid pq or data, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * int - zero if memory allocation succeeded, non-zero if failed.
+ */
+int PQEnqueueMany(pq_t *pq, void *const *data, size_t n);
+
 /* DESCRIPTION:
  * A function that removes a element from the pq with the highest priority.
  * Frees memory that was previously allocated for the element that is being 
  * removed.
  * 
- * Time complexity: O(1) 
+ * Time complexity: O(1) sorted list, O(log n) heap
  *
  * PARAMETERS:
  * pq_t *pq - pointer to pq.
@@ -108,7 +192,7 @@ void *PQDequeue(pq_t *pq);
 /* DESCRIPTION:
  * A function that returns current number of elements in a pq. 
  *
- * Time complexity: O(n)
+ * Time complexity: O(1)
  *
  * PARAMETERS:
  * pq_t *pq - pointer to a pq. 
@@ -153,7 +237,7 @@ int PQIsEmpty(const pq_t *pq);
 /* DESCRIPTION:
  * A function that erase a specific element.
  * 
- * Time complexity: O(1)
+ * Time complexity: O(n)
  *
  * PARAMETERS:
  * const pq_t *pq - pointer to a pq.
@@ -168,10 +252,43 @@ int PQIsEmpty(const pq_t *pq);
 void *PQErase(pq_t *pq, 
           int(*is_match)(const void *data, const void *params), void *params);
 
+/* DESCRIPTION:
+ * A function that erase the element in a specific position of an
+ * addressable pq.
+ * 
+ * Time complexity: O(log n)
+ *
+ * PARAMETERS:
+ * pq_t *pq - pointer to an addressable pq.
+ * size_t index - the last position reported for the element by set_index.
+ * (In case of non addressable pq or invalid index, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * void * - pointer to data of element.
+ */
+void *PQEraseAt(pq_t *pq, size_t index);
+
+/* DESCRIPTION:
+ * A function that repositions an element of an addressable pq after its
+ * priority was changed (decrease key / reschedule). The element is placed
+ * after elements that already have the same priority.
+ * 
+ * Time complexity: O(log n)
+ *
+ * PARAMETERS:
+ * pq_t *pq - pointer to an addressable pq.
+ * size_t index - the last position reported for the element by set_index.
+ * (In case of non addressable pq or invalid index, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * no return value.
+ */
+void PQUpdateAt(pq_t *pq, size_t index);
+
 /* DESCRIPTION:
  * A function that clear the queue to be empty.
  * 
- * Time complexity: O(n)
+ * Time complexity: O(n) sorted list, O(1) heap
  *
  * PARAMETERS:
  *  pq_t *pq - pointer to a pq.
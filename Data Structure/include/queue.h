@@ -1,7 +1,7 @@
 /*******************************************************************************
 *                             DS - QUEUE - HEADER FILE        
 * 												 		 
-* Description: API of Queue based on slist functions.
+* Description: API of Queue based on a ring buffer.
 * Worksheet: DS Queue										 
 * Date: 06.10.2020										 
 * InfinityLabs OL95										 
@@ -44,7 +44,7 @@ queue_t *QueueCreate(void);
  * Previously allocated memory will be freed.
  * All remaining data will be lost 
  *
- * Time complexity: O(n)
+ * Time complexity: O(1)
  *
  * PARAMETERS:
  * queue_t *queue - pointer to a queue to be 
@@ -59,12 +59,10 @@ queue_t *QueueCreate(void);
 void QueueDestroy(queue_t *queue);
 
 /* DESCRIPTION:
- * A function that creates a new queue element that holds
- * specified data 
- * and adds it to the rear of a queue. 
- * Memory will be allocated for new queue element.
+ * A function that adds specified data to the rear of a queue. 
+ * The buffer doubles when it is full, nothing is allocated otherwise.
  *
- * Time complexity: O(1) 
+ * Time complexity: O(1) amortized
  *
  * PARAMETERS:
  * queue_t *queue -	pointer to queue to be added to. 
@@ -79,8 +77,7 @@ int QueueEnqueue(queue_t *queue, const void *data);
 
 /* DESCRIPTION:
  * A function that removes a element from the front of a queue.
- * Frees memory that was previously allocated for the element that is being 
- * removed.
+ * The queue must not be empty.
  * 
  * Time complexity: O(1) 
  *
@@ -97,7 +94,7 @@ void QueueDequeue(queue_t *queue);
 /* DESCRIPTION:
  * A function that returns current number of elements in a queue. 
  *
- * Time complexity: O(n)
+ * Time complexity: O(1)
  *
  * PARAMETERS:
  * queue_t *queue - pointer to a queue. 
@@ -120,7 +117,7 @@ size_t QueueSize(const queue_t *queue);
  * (In case of pointer pointing invalid queue, behavior is undefined)
  *
  * RETURN VALUE:
- * void * - pointer to data in the front of a queue.
+ * void * - pointer to data in the front of a queue, NULL if it is empty.
  */
 void *QueuePeek(const queue_t *queue);
 
@@ -140,9 +137,11 @@ void *QueuePeek(const queue_t *queue);
 int QueueIsEmpty(const queue_t *queue);
 
 /* DESCRIPTION:
- * A function that appends source queue to destination queue.
+ * A function that appends source queue to destination queue, src is left
+ * empty. The entries are copied in at most four memcpy runs (both buffers
+ * may wrap).
  * 
- * Time complexity: O(1)
+ * Time complexity: O(n) (size of src)
  *
  * PARAMETERS:
  * queue_t *queue1 - pointer to queue1.
@@ -150,8 +149,9 @@ int QueueIsEmpty(const queue_t *queue);
  * (In case of pointer pointing to invalid variable, behavior is undefined)
  *
  * RETURN VALUE:
- * no return value.
+ * int - zero if succeeded, non-zero if memory allocation failed (both
+ * queues are left as they were).
  */
-void QueueAppend(queue_t *src, queue_t *dest);
+int QueueAppend(queue_t *src, queue_t *dest);
 
 #endif /*__ILRD_OL95_QUEUE_H__*/
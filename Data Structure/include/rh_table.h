@@ -0,0 +1,311 @@
+/*******************************************************************************
+*                          DS - RH TABLE - HEADER FILE
+*
+* Description: API of open addressing (Robin Hood) hash table functions.
+* Date: 18.10.2026
+* InfinityLabs OL95
+*******************************************************************************/
+/*--------------------------------- Header Guard -----------------------------*/
+
+#ifndef __ILRD_OL95_RH_TABLE_H__
+#define __ILRD_OL95_RH_TABLE_H__
+
+/*-------------------------- HEADER FILES ------------------------------------*/
+#include <stddef.h> /* size_t */
+
+/*------------------------- TYPEDEF ------------------------------------------*/
+
+typedef struct rh_table rh_table_t;
+
+/* hash function (same contract as the hash table one):
+genrate a hash for givin data */
+typedef size_t (*rh_hash_t)(const void *data);
+
+/* match function:
+returns 1 if match, else 0*/
+typedef int (*rh_is_match_t)(const void *table_data, const void *input_data);
+
+/* action function:
+preform an action on data, a non zero return stops the iteration */
+typedef int (*rh_action_t)(void *data, void *param);
+
+/* (in .c file:)
+
+Entries are kept in one array of slots, a slot holds the data pointer and
+its full hash. The hash is compared before is_match, so is_match is called
+only on real hash collisions, and growing does not call the hash function.
+dist holds one byte per slot: 0 for an empty slot, else the distance of the
+entry from its home slot plus one. An entry that is further from its home
+takes the slot of a closer one ("Robin Hood"), so probe lengths stay short
+and a lookup can stop at the first entry that is closer to home than itself.
+
+Growing allocates an array twice as big and moves the entries of the old
+one a few per insert / remove, lookups check both arrays meanwhile, so no
+single operation rehashes the whole table.
+
+typedef struct rh_array
+{
+	void **slots;
+	size_t *hashes;
+	unsigned char *dist;
+	size_t capacity;
+	size_t size;
+	size_t shift;
+} rh_array_t;
+
+struct rh_table
+{
+	rh_array_t arr;
+	rh_array_t old;
+	size_t cursor;
+	size_t grow_at;
+	double max_load;
+	rh_hash_t hash;
+	rh_is_match_t is_match;
+};
+
+*/
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that creates a new open addressing hash table.
+ * Memory will be specially allocated.
+ * In case of memory allocation failure, NULL will be returned.
+ * In order to avoid memory leaks, the RHTableDestroy function is requiered
+ * at end of use.
+ *
+ * Time complexity: O(capacity)
+ *
+ * PARAMETERS:
+ * size_t capacity - initial number of slots, rounded up to a power of two.
+ * rh_hash_t hash - genrate hash from data.
+ * rh_is_match_t is_match - the function to match data.
+ *
+ * RETURN VALUE:
+ * rh_table_t * - pointer to new created table, NULL if memory allocation
+ * failed.
+ */
+rh_table_t *RHTableCreate(size_t capacity, rh_hash_t hash,
+                          rh_is_match_t is_match);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that destroys a specified table.
+ * Previously allocated memory will be freed, the data is not touched.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * rh_table_t *table - pointer to a table to be destroyed
+ *
+ * (In case of pointer pointing to invalid table, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void RHTableDestroy(rh_table_t *table);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that adds data to the table. No memory is allocated per entry,
+ * the slot array doubles when the load passes the max load (7/8 unless set
+ * by RHTableSetMaxLoad). The entries are moved to the new array
+ * incrementally by the following inserts and removes.
+ * Insertion fails if more than 255 entries would probe past one slot, which
+ * only happens with a hash that maps many different keys to the same value.
+ *
+ * Time complexity: O(1) amortized
+ *
+ * PARAMETERS:
+ * rh_table_t *table - pointer to table to be added to.
+ * void *data - pointer to data to be added.
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if failed.
+ */
+int RHTableInsert(rh_table_t *table, void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes the entry that matches key. The entries after it
+ * are shifted back, so no tombstones are left behind.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * rh_table_t *table - pointer to table.
+ * const void *key - key to search for, passed to hash and is_match.
+ *
+ * RETURN VALUE:
+ * void * - the removed data, NULL if no entry matched.
+ */
+void *RHTableRemove(rh_table_t *table, const void *key);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the entry that matches key.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const rh_table_t *table - pointer to table.
+ * const void *key - key to search for, passed to hash and is_match.
+ *
+ * RETURN VALUE:
+ * void * - the data if found, else NULL.
+ */
+void *RHTableFind(const rh_table_t *table, const void *key);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * Functions like RHTableInsert, RHTableRemove and RHTableFind that take the
+ * hash of the data / key instead of calling hash, for a caller that already
+ * computed it. hash must be the value the table's hash function returns.
+ *
+ * Time complexity: O(1) amortized insert, O(1) remove and find
+ *
+ * PARAMETERS:
+ * rh_table_t *table - pointer to table.
+ * void *data / const void *key - the data to add / the key to search for.
+ * size_t hash - the hash of data / key.
+ *
+ * RETURN VALUE:
+ * as RHTableInsert, RHTableRemove and RHTableFind
+ */
+int RHTableInsertHashed(rh_table_t *table, void *data, size_t hash);
+void *RHTableRemoveHashed(rh_table_t *table, const void *key, size_t hash);
+void *RHTableFindHashed(const rh_table_t *table, const void *key, size_t hash);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that finds the entries of n keys at once, out[i] is set like
+ * RHTableFind(table, keys[i]) would return. The hashes of a group of keys
+ * are computed and their slots prefetched before any of them is searched,
+ * so the cache misses of the group overlap instead of following each
+ * other.
+ *
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * const rh_table_t *table - pointer to table.
+ * const void *const *keys - the n keys to search for.
+ * void **out - array of n results, NULL for a key that is not found.
+ * size_t n - number of keys.
+ *
+ * RETURN VALUE:
+ * no return value.
+ */
+void RHTableFindBatch(const rh_table_t *table, const void *const *keys,
+                      void **out, size_t n);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that preforms action on every entry, in slot order.
+ * The table must not be changed by the action.
+ *
+ * Time complexity: O(capacity)
+ *
+ * PARAMETERS:
+ * const rh_table_t *table - pointer to table.
+ * rh_action_t action - the action to be preformed
+ * void *param - param to the action function
+ *
+ * RETURN VALUE:
+ * int - the first non zero value returned by action, else 0.
+ */
+int RHTableForEach(const rh_table_t *table, rh_action_t action, void *param);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns current number of entries.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const rh_table_t *table - pointer to table.
+ *
+ * RETURN VALUE:
+ * size_t - current number of entries.
+ */
+size_t RHTableSize(const rh_table_t *table);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the current number of slots (of the new array
+ * while growing).
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const rh_table_t *table - pointer to table.
+ *
+ * RETURN VALUE:
+ * size_t - current number of slots.
+ */
+size_t RHTableCapacity(const rh_table_t *table);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that sets the load (entries / slots) above which the table
+ * grows. Values above 0.95 are taken as 0.95, an open addressing table
+ * needs free slots to keep the probes short.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * rh_table_t *table - pointer to table.
+ * double max_load - the new max load, greater than zero.
+ *
+ * RETURN VALUE:
+ * no return value.
+ */
+void RHTableSetMaxLoad(rh_table_t *table, double max_load);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that adds the probe length (distance of every entry from its
+ * home slot) of every entry to a histogram: hist[i] is incremented for an
+ * entry that probed i slots, the last bin also counts the longer probes.
+ * hist is not cleared first.
+ *
+ * Time complexity: O(capacity)
+ *
+ * PARAMETERS:
+ * const rh_table_t *table - pointer to table.
+ * size_t *hist - array of n_bins counters.
+ * size_t n_bins - number of bins, at least one.
+ *
+ * RETURN VALUE:
+ * size_t - the longest probe length, 0 if empty.
+ */
+size_t RHTableProbeHist(const rh_table_t *table, size_t *hist, size_t n_bins);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the standard deviation of the probe lengths
+ * (distance of every entry from its home slot).
+ *
+ * Time complexity: O(capacity)
+ *
+ * PARAMETERS:
+ * const rh_table_t *table - pointer to table.
+ *
+ * RETURN VALUE:
+ * double - standard deviation of the probe lengths, 0 if empty.
+ */
+double RHTableProbeSD(const rh_table_t *table);
+
+/*----------------------------------------------------------------------------*/
+#endif /* __ILRD_OL95_RH_TABLE_H__ */
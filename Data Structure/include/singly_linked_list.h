@@ -14,6 +14,8 @@
 /*-------------------------- HEADER FILES ------------------------------------*/
 #include <stddef.h> /* size_t */
 
+#include "fsa.h" /* fsa_pool_t */
+
 /*------------------------- TYPEDEF ------------------------------------------*/
  
 typedef struct singly_linked_list slist_t;
@@ -43,6 +45,9 @@ struct singly_linked_list
 {
 	node_t *begin;
 	node_t *end;
+	fsa_pool_t *pool;
+	int is_pool_owned;
+	size_t size;
 };
 
 */
@@ -69,6 +74,46 @@ slist_t *SListCreate(void);
 
 /*----------------------------------------------------------------------------*/
 
+/* DESCRIPTION:
+ * A function that creates a new singly linked list that takes its nodes,
+ * the dummy end node included, from an fsa pool instead of malloc. The
+ * pool's blocks must be at least SListNodeSize(). A pool may be shared by
+ * several lists, it must outlive all of them. SListAppend may be used only
+ * between lists that use the same pool.
+ * In case of memory allocation failure, NULL will be returned.
+ * In order to avoid memory leaks, the SListDestroy function is requiered at
+ * end of use.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * fsa_pool_t *pool - the pool of the nodes, NULL for a pool owned by the
+ * list and destroyed with it.
+ *
+ * RETURN VALUE:
+ * slist_t * - pointer to new created singly linked list, NULL if memory
+ * allocation failed.
+ */
+slist_t *SListCreatePooled(fsa_pool_t *pool);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the size of a list node, the block size of a pool
+ * shared by lists made with SListCreatePooled.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * function does not take any parameters
+ *
+ * RETURN VALUE:
+ * size_t - size of a node.
+ */
+size_t SListNodeSize(void);
+
+/*----------------------------------------------------------------------------*/
+
 /* DESCRIPTION:
  * A function that destroys a specified singly linked list . 
  * Previously allocated memory will be freed.
@@ -230,7 +275,7 @@ slist_iter_t SListFindIter
 /* DESCRIPTION:
  * A function that returns current number of iterators in a singly linked list. 
  *
- * Time complexity: O(n)
+ * Time complexity: O(1)
  *
  * PARAMETERS:
  * slist_t *list - pointer to a singly linked list. 
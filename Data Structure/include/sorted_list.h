@@ -72,6 +72,29 @@ sorted_list_t *SortedListCreate(compare_t compare);
 
 /*----------------------------------------------------------------------------*/
 
+/* DESCRIPTION:
+ * A function that creates a new sorted list that takes its nodes from a
+ * fsa pool, see DListCreatePooled. SortedListMerge may be used only
+ * between lists that use the same pool.
+ * In case of memory allocation failure, NULL will be returned.
+ * In order to avoid memory leaks, the SortedListDestroy function is required at
+ * end of use.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * compare_t compare - function to compare data.
+ * fsa_pool_t *pool - the pool of the nodes, NULL for a pool owned by the
+ * list and destroyed with it.
+ *
+ * RETURN VALUE:
+ * sorted_list_t * - pointer to new created sorted list, NULL if memory
+ * allocation failed.
+ */
+sorted_list_t *SortedListCreatePooled(compare_t compare, fsa_pool_t *pool);
+
+/*----------------------------------------------------------------------------*/
+
 /* DESCRIPTION:
  * A function that destroys a specified sorted list . 
  * Previously allocated memory will be freed.
@@ -229,7 +252,7 @@ sorted_list_iter_t SortedListFindIf
 /* DESCRIPTION:
  * A function that returns current number of nodes in a sorted list. 
  *
- * Time complexity: O(n)
+ * Time complexity: O(1)
  *
  * PARAMETERS:
  * sorted_list_t *list - pointer to a sorted list. 
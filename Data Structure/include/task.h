@@ -21,6 +21,22 @@ typedef int (*actionDListRemove_t)(const void *param);
 
 typedef struct task task_t;
 
+/* run statistics of a task, kept by TaskAddRun (times in ns) */
+typedef struct task_stats
+{
+	size_t executions;
+	size_t failures;
+	unsigned long run_time_total;
+	unsigned long run_time_max;
+	unsigned long lateness_max;
+} task_stats_t;
+
+/* The uid is the first member of struct task, so a task_t * can be used
+ * wherever a const ilrd_uid_t * key is expected (e.g. a UID index). */
+
+/* All execution times are in nanoseconds of a monotonic clock
+ * (CLOCK_MONOTONIC), the task itself never reads the clock. */
+
 
 /* DESCRIPTION:
  * A function that creates a new priority pq.
@@ -32,14 +48,15 @@ typedef struct task task_t;
  * Time complexity: O(1)
  *
  * PARAMETERS:
- * cmp - the users compare function
- * const void *new_data - new data to be compared
- * const void *existing_data - existing data to be compared
+ * unsigned long first_execution - first time to execute the task (ns)
+ * unsigned long interval - time between executions (ns)
+ * action - the function to preform
+ * params - parameter for the action function
  * RETURN VALUE:
- * pq_t * - pointer to new created pq, NULL if memory
+ * task_t * - pointer to new created task, NULL if memory
  * allocation failed.
  */  
-task_t *TaskCreate(time_t first_execution, size_t interval_in_sec, int(*action)(void *params), void *params);
+task_t *TaskCreate(unsigned long first_execution, unsigned long interval, int(*action)(void *params), void *params);
 									
  
 /* DESCRIPTION:
@@ -61,6 +78,32 @@ task_t *TaskCreate(time_t first_execution, size_t interval_in_sec, int(*action)(
 void TaskDestroy(task_t *task);
 
 
+/* DESCRIPTION:
+ * Function for creating a task in memory provided by the caller (e.g. a
+ * block of a fixed size allocator), at least TaskStructSize() bytes.
+ * The task must not be passed to TaskDestroy, the caller frees the memory.
+ * Time complexity: O(1) 
+ *
+ * @param:
+ * void *memory:		memory for the task
+ * other parameters as in TaskCreate
+ *
+ * @return:
+ * Returns the task (same address as memory), NULL if no uid could be created
+ */
+task_t *TaskInit(void *memory, unsigned long first_execution, unsigned long interval, int(*action)(void *params), void *params);
+
+
+/* DESCRIPTION:
+ * Function for getting the number of bytes a task takes
+ * Time complexity: O(1) 
+ *
+ * @return:
+ * Returns sizeof the task struct
+ */
+size_t TaskStructSize(void);
+
+
 /* DESCRIPTION:
  * Function for getting the tasks UID
  * In case the pointer is pointing to NULL, the behavior will be undefined
@@ -92,20 +135,93 @@ int TaskRun(const task_t *task);
 
 
 /* DESCRIPTION:
- * Function for setting the tasks first_execution.
+ * Function for moving the tasks next execution one interval forward.
+ * The new time is computed from the previous planned time and not from now,
+ * so a periodic task does not drift. Periods that were already missed
+ * by now are skipped (the task keeps its phase and does not run in bursts).
+ * A task with a zero interval is due again immediately.
  * In case the pointer is pointing to NULL,
  * the behavior will be undefined
  * Time complexity: O(1) 
  *
  * @param:
- * const task_t *task:		pointer to task to be frequency set
+ * task_t *task:		pointer to task
+ * unsigned long now:	current time (ns)
+ *
+ */
+void TaskSetNextExecution(task_t *task, unsigned long now);
+
+
+/* DESCRIPTION:
+ * Function for getting the tasks interval
+ * In case the pointer is pointing to NULL, the behavior will be undefined
+ * Time complexity: O(1) 
+ *
+ * @param:
+ * const task_t *task:		pointer to task
+ *
+ * @return:
+ * Returns the interval between executions (ns)
+ */
+unsigned long TaskGetInterval(const task_t *task);
+
+
+/* DESCRIPTION:
+ * Function for getting the tasks next execution
+ * In case the pointer is pointing to NULL, the behavior will be undefined
+ * Time complexity: O(1) 
+ *
+ * @param:
+ * const task_t *task:		pointer to task
+ *
+ * @return:
+ * Returns the time of the next execution (ns)
+ */
+unsigned long TaskGetNextExecution(const task_t *task);
+
+
+/* DESCRIPTION:
+ * Function for setting the position of the task inside an addressable pq.
+ * Matches pq_set_index_t so it can be passed to PQCreateAddressable.
+ * In case the pointer is pointing to NULL, the behavior will be undefined
+ * Time complexity: O(1) 
+ *
+ * @param:
+ * void *task:		pointer to task
+ * size_t index:	the new position
+ */
+void TaskSetPQIndex(void *task, size_t index);
+
+
+/* DESCRIPTION:
+ * Function for getting the position of the task inside an addressable pq
+ * In case the pointer is pointing to NULL, the behavior will be undefined
+ * Time complexity: O(1) 
+ *
+ * @param:
+ * const task_t *task:		pointer to task
  *
+ * @return:
+ * Returns the last position set by TaskSetPQIndex
  */
-void TaskSetNextExecution(task_t *task, size_t next_execution);
+size_t TaskGetPQIndex(const task_t *task);
 
 
 /* DESCRIPTION:
- * Function for getting the tasks frequency_in_sec
+ * Function for keeping an opaque handle of the structure that currently
+ * holds the task (e.g. its timing wheel timer).
+ * In case the pointer is pointing to NULL, the behavior will be undefined
+ * Time complexity: O(1) 
+ *
+ * @param:
+ * task_t *task:		pointer to task
+ * void *handle:		the handle to keep
+ */
+void TaskSetSchedHandle(task_t *task, void *handle);
+
+
+/* DESCRIPTION:
+ * Function for getting the handle set by TaskSetSchedHandle
  * In case the pointer is pointing to NULL, the behavior will be undefined
  * Time complexity: O(1) 
  *
@@ -113,13 +229,27 @@ void TaskSetNextExecution(task_t *task, size_t next_execution);
  * const task_t *task:		pointer to task
  *
  * @return:
- * Returns size_t frequency_in_sec
+ * Returns the handle, NULL if none was set
+ */
+void *TaskGetSchedHandle(const task_t *task);
+
+
+/* DESCRIPTION:
+ * Function for adding one execution to the run statistics of the task
+ * In case the pointer is pointing to NULL, the behavior will be undefined
+ * Time complexity: O(1) 
+ *
+ * @param:
+ * task_t *task:				pointer to task
+ * unsigned long lateness:		start of the run minus its planned time (ns)
+ * unsigned long run_time:		duration of the run (ns)
+ * int is_failed:				non-zero if the run failed
  */
-size_t TaskGetFrequencyInSec(const task_t *task);
+void TaskAddRun(task_t *task, unsigned long lateness, unsigned long run_time, int is_failed);
 
 
 /* DESCRIPTION:
- * Function for getting the tasks first_execution
+ * Function for getting the run statistics of the task
  * In case the pointer is pointing to NULL, the behavior will be undefined
  * Time complexity: O(1) 
  *
@@ -127,9 +257,9 @@ size_t TaskGetFrequencyInSec(const task_t *task);
  * const task_t *task:		pointer to task
  *
  * @return:
- * Returns time_t first_execution
+ * Returns the statistics, all zero if the task did not run
  */
-size_t TaskGetFirstExecution(const task_t *task);
+const task_stats_t *TaskGetStats(const task_t *task);
 
 #endif /* __ILRD_OL95_TASK_H */
 
@@ -0,0 +1,253 @@
+/*******************************************************************************
+*                          DS - TIMING WHEEL - HEADER FILE
+*
+* Description: API of hierarchical timing wheel functions.
+* Date: 18.10.2026
+* InfinityLabs OL95
+*******************************************************************************/
+/*--------------------------------- Header Guard -----------------------------*/
+
+#ifndef __ILRD_OL95_TIMING_WHEEL_H__
+#define __ILRD_OL95_TIMING_WHEEL_H__
+
+/*-------------------------- HEADER FILES ------------------------------------*/
+#include <stddef.h> /* size_t */
+
+/*------------------------- TYPEDEF ------------------------------------------*/
+
+typedef struct timing_wheel timing_wheel_t;
+
+typedef struct tw_timer tw_timer_t;
+
+/* action function:
+preform an action on data of a timer that is being cleared */
+typedef void (*tw_action_t)(void *data, void *param);
+
+/* (in .c file:)
+
+The wheel has 5 levels: level 0 has 256 slots of one tick, every other level
+has 64 slots that each cover all the slots of the level below it.
+A timer is kept in the level that covers its distance from the current tick
+and is moved ("cascaded") one level down every time the current tick crosses
+the start of its slot, until it reaches level 0.
+
+struct tw_timer
+{
+	tw_timer_t *next;
+	tw_timer_t *prev;
+	void *data;
+	unsigned long expire;
+	int level;
+	int is_owned;
+};
+
+struct timing_wheel
+{
+	tw_timer_t slots[TW_SLOTS_TOTAL];
+	size_t level_count[TW_LEVELS];
+	size_t size;
+	unsigned long current;
+};
+
+*/
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that creates a new timing wheel.
+ * Memory will be specially allocated.
+ * In case of memory allocation failure, NULL will be returned.
+ * In order to avoid memory leaks, the TimingWheelDestroy function is
+ * requiered at end of use.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * unsigned long now - the current tick.
+ *
+ * RETURN VALUE:
+ * timing_wheel_t * - pointer to new created wheel, NULL if memory
+ * allocation failed.
+ */
+timing_wheel_t *TimingWheelCreate(unsigned long now);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that destroys a specified timing wheel.
+ * Previously allocated memory will be freed.
+ * The data of remaining timers is not touched.
+ *
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * timing_wheel_t *wheel - pointer to a wheel to be destroyed
+ *
+ * (In case of pointer pointing to invalid wheel, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void TimingWheelDestroy(timing_wheel_t *wheel);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that adds a timer holding data that expires at a given tick.
+ * A timer that is already due expires on the next TimingWheelPopExpired.
+ * Memory will be allocated for the new timer.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * timing_wheel_t *wheel - pointer to a wheel.
+ * void *data - pointer to data to be added.
+ * unsigned long expire - the tick in which the timer expires.
+ *
+ * (In case of pointers pointing to invalid wheel, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * tw_timer_t * - handle of the new timer, NULL if memory allocation failed.
+ */
+tw_timer_t *TimingWheelAdd(timing_wheel_t *wheel, void *data,
+                           unsigned long expire);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * Same as TimingWheelAdd, the timer is placed in memory provided by the
+ * caller (at least TimingWheelTimerSize() bytes) so no allocation is done.
+ * The wheel never frees such a timer, the memory may be reused once the
+ * timer was removed, expired or cleared.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * timing_wheel_t *wheel - pointer to a wheel.
+ * void *memory - memory for the timer.
+ * void *data - pointer to data to be added.
+ * unsigned long expire - the tick in which the timer expires.
+ *
+ * RETURN VALUE:
+ * tw_timer_t * - handle of the new timer (same address as memory).
+ */
+tw_timer_t *TimingWheelAddAt(timing_wheel_t *wheel, void *memory, void *data,
+                             unsigned long expire);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes a pending timer and frees it (unless it was added
+ * with TimingWheelAddAt).
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * timing_wheel_t *wheel - pointer to a wheel.
+ * tw_timer_t *timer - handle returned by TimingWheelAdd.
+ *
+ * (In case of handle of an expired or removed timer, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * void * - the data of the timer.
+ */
+void *TimingWheelRemove(timing_wheel_t *wheel, tw_timer_t *timer);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that advances the wheel up to now and removes one expired timer.
+ * Timers are returned tick by tick, the order inside a tick is not specified.
+ * The timer handle is freed (unless it was added with TimingWheelAddAt).
+ *
+ * Time complexity: O(1) amortized per tick and per timer
+ *
+ * PARAMETERS:
+ * timing_wheel_t *wheel - pointer to a wheel.
+ * unsigned long now - the current tick.
+ *
+ * RETURN VALUE:
+ * void * - the data of an expired timer, NULL if no timer is due.
+ */
+void *TimingWheelPopExpired(timing_wheel_t *wheel, unsigned long now);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns a lower bound of the earliest expiration.
+ * The result is exact when that timer is already in level 0 (less than 256
+ * ticks away), otherwise it is the start tick of its slot, so a caller that
+ * sleeps until it may wake up early and has to ask again.
+ *
+ * Time complexity: O(1) (bounded by the number of slots)
+ *
+ * PARAMETERS:
+ * const timing_wheel_t *wheel - pointer to a wheel.
+ *
+ * RETURN VALUE:
+ * unsigned long - tick of the next expiration, the current tick if the
+ * wheel is empty.
+ */
+unsigned long TimingWheelNextExpiry(const timing_wheel_t *wheel);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes all timers, calling action on the data of each.
+ *
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * timing_wheel_t *wheel - pointer to a wheel.
+ * tw_action_t action - action to preform on each data, may be NULL.
+ * void *param - param to the action function
+ *
+ * RETURN VALUE:
+ * no return value.
+ */
+void TimingWheelClear(timing_wheel_t *wheel, tw_action_t action, void *param);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns current number of pending timers.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const timing_wheel_t *wheel - pointer to a wheel.
+ *
+ * RETURN VALUE:
+ * size_t - current number of pending timers.
+ */
+size_t TimingWheelSize(const timing_wheel_t *wheel);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the number of bytes a timer takes, for
+ * TimingWheelAddAt.
+ *
+ * Time complexity: O(1)
+ *
+ * RETURN VALUE:
+ * size_t - size of a timer.
+ */
+size_t TimingWheelTimerSize(void);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that checks if a wheel has no pending timers.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const timing_wheel_t *wheel - pointer to a wheel.
+ *
+ * RETURN VALUE:
+ * int - one if wheel is empty, zero if not.
+ */
+int TimingWheelIsEmpty(const timing_wheel_t *wheel);
+
+/*----------------------------------------------------------------------------*/
+#endif /* __ILRD_OL95_TIMING_WHEEL_H__ */
@@ -31,6 +31,7 @@ extern ilrd_uid_t BAD_UID;
 /* DESCRIPTION:
  * A function that creates a new unique identifier uid.
  * in case the create failed a non valid UID 
+ * Thread safe and lock free, a forked child keeps creating unique uids.
  * Time complexity: O(1)
  *
  * PARAMETERS:
@@ -43,6 +44,23 @@ ilrd_uid_t UIDCreate(void);
 
 /*----------------------------------------------------------------------------*/
 
+/* DESCRIPTION:
+ * A function that creates n unique identifiers at once, the range is
+ * reserved with a single atomic operation.
+ * Thread safe and lock free.
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * ilrd_uid_t *out - array of at least n uids to be filled.
+ * size_t n - number of uids to create.
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if failed (out is not valid).
+ */
+int UIDCreateN(ilrd_uid_t *out, size_t n);
+
+/*----------------------------------------------------------------------------*/
+
 /* DESCRIPTION:
  * A function that checks if two uids are the same.
  * 
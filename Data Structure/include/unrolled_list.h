@@ -0,0 +1,329 @@
+/*******************************************************************************
+*                        DS - UNROLLED LIST - HEADER FILE
+*
+* Description: API of a doubly linked list that keeps many elements per node.
+* Date: 18.10.2026
+* InfinityLabs OL95
+*******************************************************************************/
+/*--------------------------------- Header Guard -----------------------------*/
+
+#ifndef __ILRD_OL95_UNROLLED_LIST_H__
+#define __ILRD_OL95_UNROLLED_LIST_H__
+
+/*-------------------------- HEADER FILES ------------------------------------*/
+#include <stddef.h> /* size_t */
+
+/*------------------------- TYPEDEF ------------------------------------------*/
+
+/* elements per node, can be overridden when building the library
+ * (e.g. -DULIST_NODE_CAPACITY=64). 32 pointers fill four cache lines. */
+#ifndef ULIST_NODE_CAPACITY
+#define ULIST_NODE_CAPACITY (32)
+#endif
+
+typedef struct unrolled_list ulist_t;
+
+typedef struct ulist_node ulist_node_t;
+
+typedef struct ulist_iter ulist_iter_t;
+
+/* match function:
+returns 1 if match, else 0 */
+typedef int (*ulist_is_match_t)(const void *data1, const void *data2);
+
+/* action function:
+preform an action on data, returns zero if succeeded, non-zero stops the
+iteration */
+typedef int (*ulist_action_t)(void *data, void *param);
+
+/* an iterator is a node and a position in it. Inserting or removing moves
+the elements after it in the same node (and may split or merge nodes), so
+unlike a dlist iterator, every iterator of the list other than the returned
+one is invalid after UListInsert / UListRemove. */
+struct ulist_iter
+{
+	ulist_node_t *node;
+	size_t index;
+};
+
+/* (in .c file:)
+
+The elements of a node are kept packed at the start of data, every node
+but the sentinel holds at least one. A full node is split in two halves on
+insert, a node is merged with the next one when both fit in half a node
+after a remove. The end iterator is {&sentinel, 0}.
+
+struct ulist_node
+{
+	ulist_node_t *next;
+	ulist_node_t *prev;
+	size_t count;
+	void *data[ULIST_NODE_CAPACITY];
+};
+
+struct unrolled_list
+{
+	ulist_node_t sentinel;
+	size_t size;
+};
+
+*/
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that creates a new unrolled list.
+ * In case of memory allocation failure, NULL will be returned.
+ * In order to avoid memory leaks, the UListDestroy function is required at
+ * end of use.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * function does not take any parameters
+ *
+ * RETURN VALUE:
+ * ulist_t * - pointer to new created list, NULL if memory allocation failed.
+ */
+ulist_t *UListCreate(void);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that destroys a list. The data is not freed.
+ *
+ * Time complexity: O(n / ULIST_NODE_CAPACITY)
+ *
+ * PARAMETERS:
+ * ulist_t *list - pointer to a list to be destroyed.
+ *
+ * RETURN VALUE:
+ * no return value
+ */
+void UListDestroy(ulist_t *list);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that inserts data before an iterator.
+ *
+ * Time complexity: O(ULIST_NODE_CAPACITY)
+ *
+ * PARAMETERS:
+ * ulist_t *list - pointer to a list.
+ * ulist_iter_t where - the data is inserted before it, can be the end.
+ * const void *data - the data.
+ *
+ * RETURN VALUE:
+ * ulist_iter_t - iterator to the inserted data, the end iterator if memory
+ * allocation failed.
+ */
+ulist_iter_t UListInsert(ulist_t *list, ulist_iter_t where, const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that removes the data at an iterator.
+ *
+ * Time complexity: O(ULIST_NODE_CAPACITY)
+ *
+ * PARAMETERS:
+ * ulist_t *list - pointer to a list.
+ * ulist_iter_t iter - iterator to the data to remove, not the end.
+ *
+ * RETURN VALUE:
+ * ulist_iter_t - iterator to the data that followed the removed one.
+ */
+ulist_iter_t UListRemove(ulist_t *list, ulist_iter_t iter);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * Functions that add data at the end / the start of a list.
+ *
+ * Time complexity: O(1) push back, O(ULIST_NODE_CAPACITY) push front
+ *
+ * PARAMETERS:
+ * ulist_t *list - pointer to a list.
+ * const void *data - the data.
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if memory allocation failed.
+ */
+int UListPushBack(ulist_t *list, const void *data);
+int UListPushFront(ulist_t *list, const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * Functions that remove and return the last / the first data of a list.
+ * The list must not be empty.
+ *
+ * Time complexity: O(1) pop back, O(ULIST_NODE_CAPACITY) pop front
+ *
+ * PARAMETERS:
+ * ulist_t *list - pointer to a list.
+ *
+ * RETURN VALUE:
+ * void * - the removed data.
+ */
+void *UListPopBack(ulist_t *list);
+void *UListPopFront(ulist_t *list);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that moves the data of [from, to) of src_list before dest_iter
+ * of dest_list, in order. The lists must be different.
+ *
+ * Time complexity: O(number of moved elements)
+ *
+ * PARAMETERS:
+ * ulist_t *dest_list - the list to move to.
+ * ulist_iter_t dest_iter - the data is moved before it, can be the end.
+ * ulist_t *src_list - the list to move from.
+ * ulist_iter_t from - first iterator of the range.
+ * ulist_iter_t to - iterator after the range.
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if memory allocation failed (the
+ * elements moved so far stay in dest_list, the rest in src_list).
+ */
+int UListSplice(ulist_t *dest_list, ulist_iter_t dest_iter, ulist_t *src_list,
+                ulist_iter_t from, ulist_iter_t to);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that finds the first data in [from, to) that matches data.
+ * The elements of a node are scanned as one array.
+ *
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * ulist_iter_t from - first iterator of the range.
+ * ulist_iter_t to - iterator after the range.
+ * ulist_is_match_t is_match - the match function.
+ * const void *data - passed to is_match as the second argument.
+ *
+ * RETURN VALUE:
+ * ulist_iter_t - iterator to the match, to if not found.
+ */
+ulist_iter_t UListFind(ulist_iter_t from, ulist_iter_t to,
+                       ulist_is_match_t is_match, const void *data);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that preforms action on every data in [from, to), stops at the
+ * first non zero return.
+ *
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ * ulist_iter_t from - first iterator of the range.
+ * ulist_iter_t to - iterator after the range.
+ * ulist_action_t action - the action.
+ * void *param - param to the action.
+ *
+ * RETURN VALUE:
+ * int - zero if all actions succeeded, else non-zero.
+ */
+int UListForEach(ulist_iter_t from, ulist_iter_t to, ulist_action_t action,
+                 void *param);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the number of elements in a list.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const ulist_t *list - pointer to a list.
+ *
+ * RETURN VALUE:
+ * size_t - number of elements.
+ */
+size_t UListSize(const ulist_t *list);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that checks if a list is empty.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const ulist_t *list - pointer to a list.
+ *
+ * RETURN VALUE:
+ * int - 1 if empty, else 0.
+ */
+int UListIsEmpty(const ulist_t *list);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * Functions that return the first iterator and the end iterator (after the
+ * last element) of a list.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * const ulist_t *list - pointer to a list.
+ *
+ * RETURN VALUE:
+ * ulist_iter_t - the iterator, the end iterator if the list is empty.
+ */
+ulist_iter_t UListBegin(const ulist_t *list);
+ulist_iter_t UListEnd(const ulist_t *list);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * Functions that return the next / the previous iterator. The next of the
+ * last element is the end, the previous of the end is the last element.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * ulist_iter_t iter - an iterator.
+ *
+ * RETURN VALUE:
+ * ulist_iter_t - the next / the previous iterator.
+ */
+ulist_iter_t UListNextIter(ulist_iter_t iter);
+ulist_iter_t UListPrevIter(ulist_iter_t iter);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that returns the data at an iterator, not the end.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * ulist_iter_t iter - an iterator.
+ *
+ * RETURN VALUE:
+ * void * - the data.
+ */
+void *UListGetData(ulist_iter_t iter);
+
+/*----------------------------------------------------------------------------*/
+
+/* DESCRIPTION:
+ * A function that checks if two iterators are the same.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * ulist_iter_t iter1, iter2 - iterators.
+ *
+ * RETURN VALUE:
+ * int - 1 if same, else 0.
+ */
+int UListIsSameIter(ulist_iter_t iter1, ulist_iter_t iter2);
+
+/*----------------------------------------------------------------------------*/
+#endif /* __ILRD_OL95_UNROLLED_LIST_H__ */
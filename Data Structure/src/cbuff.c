@@ -5,30 +5,40 @@ Reviewer : Ron Benyamin
 Infinity Labs OL95	
 *******************************************/
 
+#define _POSIX_C_SOURCE 200112L	/* posix_memalign */
+
 /* 				External Libraries
 -------------------------------------------*/
 
-#include <stdlib.h>	/*malloc, free*/
+#include <stdlib.h>	/*posix_memalign, free*/
+#include <string.h>	/*memcpy*/
 #include <assert.h>	/*assert*/
 #include "cbuff.h"	/*Circular beffer functions*/
 
-#define INDEX_OF_ELEMENT(element, capacity) (element % capacity)
+#define CBUFF_CACHE_LINE (64)
 
+/* read is written only by the reader and write only by the writer, in SPSC
+   mode they sit on different cache lines so the two threads do not keep
+   taking the line from each other. That holds only if the struct starts on
+   a cache line, so it is allocated with posix_memalign and not malloc */
 struct circular_buffer
 {
 	size_t read;
+	char read_pad[CBUFF_CACHE_LINE - sizeof(size_t)];
 	size_t write;
+	char write_pad[CBUFF_CACHE_LINE - sizeof(size_t)];
 	size_t capacity;
+	size_t mask;
+	int is_spsc;
 	char data[1];
 };
 
-static int CBuffIsFull(const c_buff_t *cbuff)
-{
-	assert(NULL != cbuff);
-	
-	return ((cbuff->write - cbuff->read) == cbuff->capacity);
-	
-}
+static size_t SPSCRead(c_buff_t *cbuff, char *dest, size_t count);
+static size_t SPSCWrite(c_buff_t *cbuff, const char *src, size_t count);
+static size_t IndexOf(const c_buff_t *cbuff, size_t element);
+static void CopyOut(const c_buff_t *cbuff, size_t from, char *dest,
+                    size_t count);
+static void CopyIn(c_buff_t *cbuff, size_t to, const char *src, size_t count);
 
 static void CircularIndexsReset(c_buff_t *cbuff)
 {
@@ -46,25 +56,51 @@ int CBuffIsEmpty(const c_buff_t *cbuff)
 {
 	assert(NULL != cbuff);
 	
+	if(cbuff->is_spsc)
+	{
+		return (__atomic_load_n(&cbuff->write, __ATOMIC_ACQUIRE) ==
+		        __atomic_load_n(&cbuff->read, __ATOMIC_ACQUIRE));
+	}
+	
 	return(cbuff->write == cbuff->read);
 	
 }
 
 c_buff_t *CBuffCreate(size_t capacity)
 {
-	c_buff_t *new_buff = (c_buff_t *)malloc(sizeof(c_buff_t) + capacity);
-	if(NULL == new_buff)
+	c_buff_t *new_buff = NULL;
+	void *mem = NULL;
+	
+	if(0 != posix_memalign(&mem, CBUFF_CACHE_LINE, sizeof(c_buff_t) + capacity))
 	{
 		return NULL;
 	}
 	
+	new_buff = (c_buff_t *)mem;
+	
 	new_buff->read = 0UL;
 	new_buff->write = 0UL;
 	new_buff-> capacity = capacity;
+	/* a power of two capacity is indexed with a mask instead of % */
+	new_buff->mask = (0 != capacity && 0 == (capacity & (capacity - 1))) ?
+	                 capacity - 1 : 0;
+	new_buff->is_spsc = 0;
 	return new_buff;
 	
 }
 
+c_buff_t *CBuffCreateSPSC(size_t capacity)
+{
+	c_buff_t *new_buff = CBuffCreate(capacity);
+	
+	if(NULL != new_buff)
+	{
+		new_buff->is_spsc = 1;
+	}
+	
+	return new_buff;
+}
+
 void CBuffDestroy(c_buff_t *cbuff)
 {
 	assert(NULL != cbuff);
@@ -80,14 +116,18 @@ size_t CBuffRead(c_buff_t *cbuff, void *dest, size_t count)
 	assert(NULL != cbuff);
 	assert(NULL != dest);
 	
-	while((num_of_copied_bytes < count) && (CBuffIsEmpty(cbuff) == 0))
+	if(cbuff->is_spsc)
 	{
-		*(char *)dest = cbuff->data[INDEX_OF_ELEMENT(cbuff->read,cbuff->capacity)];
-		++(cbuff->read);
-		dest =(char *)dest + 1;
-		++num_of_copied_bytes;
+		return SPSCRead(cbuff, (char *)dest, count);
 	}
 	
+	num_of_copied_bytes = cbuff->write - cbuff->read;
+	num_of_copied_bytes = (count < num_of_copied_bytes) ? count :
+	                                                      num_of_copied_bytes;
+	
+	CopyOut(cbuff, cbuff->read, (char *)dest, num_of_copied_bytes);
+	cbuff->read += num_of_copied_bytes;
+	
  	CircularIndexsReset(cbuff);
 	
 	return num_of_copied_bytes;
@@ -101,14 +141,18 @@ size_t CBuffWrite(c_buff_t *cbuff, void *src, size_t count)
 	assert(NULL != cbuff);
 	assert(NULL != src);
 	
-	while((num_of_copied_bytes < count) && CBuffIsFull(cbuff) == 0)
+	if(cbuff->is_spsc)
 	{
-		cbuff->data[INDEX_OF_ELEMENT(cbuff->write,cbuff->capacity)] = *(char *)src;
-		++(cbuff->write);
-		src = (char *)src + 1;
-		++num_of_copied_bytes;
+		return SPSCWrite(cbuff, (const char *)src, count);
 	}
 	
+	num_of_copied_bytes = CBuffFreeSpace(cbuff);
+	num_of_copied_bytes = (count < num_of_copied_bytes) ? count :
+	                                                      num_of_copied_bytes;
+	
+	CopyIn(cbuff, cbuff->write, (const char *)src, num_of_copied_bytes);
+	cbuff->write += num_of_copied_bytes;
+	
 	return num_of_copied_bytes;
 	
 }
@@ -118,6 +162,14 @@ size_t CBuffFreeSpace(const c_buff_t *cbuff)
 {
 	assert(NULL != cbuff);
 	
+	if(cbuff->is_spsc)
+	{
+		size_t read = __atomic_load_n(&cbuff->read, __ATOMIC_ACQUIRE);
+		
+		return (cbuff->capacity -
+		        (__atomic_load_n(&cbuff->write, __ATOMIC_ACQUIRE) - read));
+	}
+	
 	return (cbuff->capacity - (cbuff->write - cbuff->read));
 	
 }
@@ -130,4 +182,85 @@ size_t CBuffCapacity(const c_buff_t *cbuff)
 	
 }
 
+/*----------------------------------------------------------------------------*/
 
+/* The indices only grow (a size_t does not wrap in practice, and with a
+   power of two capacity the wrap is harmless anyway), so neither
+   thread ever writes the index of the other. Each side reads the other's
+   index with acquire, so the bytes it published are visible, and hands the
+   bytes over by storing its own index with release after copying them. */
+static size_t SPSCRead(c_buff_t *cbuff, char *dest, size_t count)
+{
+	size_t read = cbuff->read;
+	size_t available = __atomic_load_n(&cbuff->write, __ATOMIC_ACQUIRE) - read;
+	
+	count = (count < available) ? count : available;
+	CopyOut(cbuff, read, dest, count);
+	
+	__atomic_store_n(&cbuff->read, read + count, __ATOMIC_RELEASE);
+	
+	return count;
+}
+
+static size_t SPSCWrite(c_buff_t *cbuff, const char *src, size_t count)
+{
+	size_t write = cbuff->write;
+	size_t free_space = cbuff->capacity -
+	                    (write - __atomic_load_n(&cbuff->read, __ATOMIC_ACQUIRE));
+	
+	count = (count < free_space) ? count : free_space;
+	CopyIn(cbuff, write, src, count);
+	
+	__atomic_store_n(&cbuff->write, write + count, __ATOMIC_RELEASE);
+	
+	return count;
+}
+
+static size_t IndexOf(const c_buff_t *cbuff, size_t element)
+{
+	if(0 != cbuff->mask)
+	{
+		return (element & cbuff->mask);
+	}
+	
+	return (element % cbuff->capacity);
+}
+
+/* the bytes from element from on are at most two runs: up to the end of
+   data, then from its start */
+static void CopyOut(const c_buff_t *cbuff, size_t from, char *dest,
+                    size_t count)
+{
+	size_t start = 0;
+	size_t first = 0;
+	
+	if(0 == count)
+	{
+		return;
+	}
+	
+	start = IndexOf(cbuff, from);
+	first = cbuff->capacity - start;
+	first = (count < first) ? count : first;
+	
+	memcpy(dest, cbuff->data + start, first);
+	memcpy(dest + first, cbuff->data, count - first);
+}
+
+static void CopyIn(c_buff_t *cbuff, size_t to, const char *src, size_t count)
+{
+	size_t start = 0;
+	size_t first = 0;
+	
+	if(0 == count)
+	{
+		return;
+	}
+	
+	start = IndexOf(cbuff, to);
+	first = cbuff->capacity - start;
+	first = (count < first) ? count : first;
+	
+	memcpy(cbuff->data + start, src, first);
+	memcpy(cbuff->data, src + first, count - first);
+}
@@ -0,0 +1,255 @@
+/********************************************
+File name : concurrent_hash_table.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+#define _POSIX_C_SOURCE 200112L	/* pthread_rwlock, posix_memalign */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <assert.h>	/* assert */
+#include <stdlib.h>	/* posix_memalign, malloc, free */
+#include <limits.h>	/* CHAR_BIT */
+#include <pthread.h>	/* pthread_rwlock */
+
+#include "hash_table.h" /* hash table API */
+#include "concurrent_hash_table.h" /* concurrent hash table API */
+
+#define CHT_CACHE_LINE (64)
+#define CHT_SIZE_BITS (sizeof(size_t) * CHAR_BIT)
+/* both shard backends place entries by the top bits of hash * golden
+   ratio, a different odd multiplier keeps the shard choice independent of
+   them */
+#define CHT_SHARD_MULT ((size_t)0xC2B2AE3D27D4EB4FUL)
+
+/* CHT_SHARD_MULT needs a 64 bit size_t, the build fails here on a
+   narrower one */
+typedef char size_t_is_64_bits[(8 == sizeof(size_t)) ? 1 : -1];
+
+typedef struct cht_shard
+{
+	pthread_rwlock_t lock;
+	hash_table_t *table;
+} cht_shard_t;
+
+typedef union cht_slot
+{
+	cht_shard_t shard;
+	char pad[(sizeof(cht_shard_t) + CHT_CACHE_LINE - 1) /
+	         CHT_CACHE_LINE * CHT_CACHE_LINE];
+} cht_slot_t;
+
+struct concurrent_hash_table
+{
+	cht_slot_t *shards;
+	size_t n_shards;
+	hash_function_t hash_func;
+};
+
+static cht_shard_t *GetShard(const concurrent_hash_table_t *table,
+                             size_t hash);
+static void DestroyShards(concurrent_hash_table_t *table, size_t n_shards);
+
+/*----------------------------------------------------------------------------*/
+
+concurrent_hash_table_t *ConcurrentHashTableCreate(size_t table_size,
+                     hash_function_t hash_func, is_match_hash_t match_func)
+{
+	return ConcurrentHashTableCreateShards(table_size, CHT_DEFAULT_SHARDS,
+	                                       hash_func, match_func);
+}
+
+concurrent_hash_table_t *ConcurrentHashTableCreateShards(size_t table_size,
+    size_t n_shards, hash_function_t hash_func, is_match_hash_t match_func)
+{
+	concurrent_hash_table_t *table = NULL;
+	void *shards = NULL;
+	size_t shard_size = 0;
+	size_t idx = 0;
+
+	assert(NULL != hash_func);
+	assert(NULL != match_func);
+	assert(0 < n_shards);
+
+	table = (concurrent_hash_table_t *)malloc(sizeof(concurrent_hash_table_t));
+	if(NULL == table)
+	{
+		return NULL;
+	}
+
+	if(0 != posix_memalign(&shards, CHT_CACHE_LINE,
+	                       sizeof(cht_slot_t) * n_shards))
+	{
+		free(table);
+		return NULL;
+	}
+
+	table->shards = (cht_slot_t *)shards;
+	table->n_shards = n_shards;
+	table->hash_func = hash_func;
+
+	shard_size = (table_size + n_shards - 1) / n_shards;
+	shard_size = (0 == shard_size) ? 1 : shard_size;
+
+	for(; idx < n_shards; ++idx)
+	{
+		cht_shard_t *shard = &table->shards[idx].shard;
+
+		shard->table = HashTableCreate(shard_size, hash_func, match_func);
+		if(NULL == shard->table)
+		{
+			DestroyShards(table, idx);
+			return NULL;
+		}
+
+		if(0 != pthread_rwlock_init(&shard->lock, NULL))
+		{
+			HashTableDestroy(shard->table);
+			DestroyShards(table, idx);
+			return NULL;
+		}
+	}
+
+	return table;
+}
+
+void ConcurrentHashTableDestroy(concurrent_hash_table_t *table)
+{
+	assert(NULL != table);
+
+	DestroyShards(table, table->n_shards);
+}
+
+int ConcurrentHashTableInsert(concurrent_hash_table_t *table, void *data)
+{
+	cht_shard_t *shard = NULL;
+	size_t hash = 0;
+	int res = 0;
+
+	assert(NULL != table);
+	assert(NULL != data);
+
+	/* hashed once, outside the lock, for both the shard and its table */
+	hash = table->hash_func(data);
+	shard = GetShard(table, hash);
+	pthread_rwlock_wrlock(&shard->lock);
+	res = HashTableInsertHashed(shard->table, data, hash);
+	pthread_rwlock_unlock(&shard->lock);
+
+	return res;
+}
+
+void ConcurrentHashTableRemove(concurrent_hash_table_t *table,
+                               const void *data)
+{
+	cht_shard_t *shard = NULL;
+	size_t hash = 0;
+
+	assert(NULL != table);
+	assert(NULL != data);
+
+	hash = table->hash_func(data);
+	shard = GetShard(table, hash);
+	pthread_rwlock_wrlock(&shard->lock);
+	HashTableRemoveHashed(shard->table, data, hash);
+	pthread_rwlock_unlock(&shard->lock);
+}
+
+void *ConcurrentHashTableFind(const concurrent_hash_table_t *table,
+                              const void *data)
+{
+	cht_shard_t *shard = NULL;
+	size_t hash = 0;
+	void *res = NULL;
+
+	assert(NULL != table);
+	assert(NULL != data);
+
+	/* HashTableFind does not change the table, readers can share the lock */
+	hash = table->hash_func(data);
+	shard = GetShard(table, hash);
+	pthread_rwlock_rdlock(&shard->lock);
+	res = HashTableFindHashed(shard->table, data, hash);
+	pthread_rwlock_unlock(&shard->lock);
+
+	return res;
+}
+
+size_t ConcurrentHashTableSize(const concurrent_hash_table_t *table)
+{
+	size_t size = 0;
+	size_t idx = 0;
+
+	assert(NULL != table);
+
+	for(; idx < table->n_shards; ++idx)
+	{
+		cht_shard_t *shard = &table->shards[idx].shard;
+
+		pthread_rwlock_rdlock(&shard->lock);
+		size += HashTableSize(shard->table);
+		pthread_rwlock_unlock(&shard->lock);
+	}
+
+	return size;
+}
+
+int ConcurrentHashTableIsEmpty(const concurrent_hash_table_t *table)
+{
+	assert(NULL != table);
+
+	return (0 == ConcurrentHashTableSize(table));
+}
+
+int ConcurrentHashTableForEach(const concurrent_hash_table_t *table,
+                               hash_action_t hash_action, void *param)
+{
+	size_t idx = 0;
+	int res = 0;
+
+	assert(NULL != table);
+	assert(NULL != hash_action);
+
+	for(; idx < table->n_shards && 0 == res; ++idx)
+	{
+		cht_shard_t *shard = &table->shards[idx].shard;
+
+		pthread_rwlock_rdlock(&shard->lock);
+		res = HashTableForEach(shard->table, hash_action, param);
+		pthread_rwlock_unlock(&shard->lock);
+	}
+
+	return res;
+}
+
+/*----------------------------------------------------------------------------*/
+
+static cht_shard_t *GetShard(const concurrent_hash_table_t *table,
+                             size_t hash)
+{
+	hash *= CHT_SHARD_MULT;
+
+	/* the high bits of the product are the best mixed ones */
+	hash ^= hash >> (CHT_SIZE_BITS / 2);
+
+	return &table->shards[hash % table->n_shards].shard;
+}
+
+static void DestroyShards(concurrent_hash_table_t *table, size_t n_shards)
+{
+	size_t idx = 0;
+
+	for(; idx < n_shards; ++idx)
+	{
+		cht_shard_t *shard = &table->shards[idx].shard;
+
+		pthread_rwlock_destroy(&shard->lock);
+		HashTableDestroy(shard->table);
+	}
+
+	free(table->shards); table->shards = NULL;
+	free(table); table = NULL;
+}
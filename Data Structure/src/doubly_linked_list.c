@@ -11,21 +11,26 @@ Infinity Labs OL95
 #include <assert.h>	/*assert*/
 #include <stdlib.h>	/* malloc, free, size_t */
 #include "doubly_linked_list.h" /* doubly_linked_list functions*/
+#include "fsa.h" /* fsa_pool_t */
 
-struct node 
-{
-	void *data;
-	node_t *next;
-	node_t *prev;
-};
+#define LIST_POOL_BLOCKS (16)
 
 struct doubly_linked_list 
 {
 	node_t head;
 	node_t tail;
-	
+	int is_intrusive;
+	fsa_pool_t *pool;
+	int is_pool_owned;
+	size_t size;
 };
 
+static void Link(node_t *next, node_t *new_node, const void *data);
+static void Unlink(node_t *node);
+static node_t *AllocNode(dlist_t *list);
+static void FreeNode(dlist_t *list, node_t *node);
+static size_t CountRange(const node_t *from, const node_t *to);
+
 
 dlist_t *DListCreate(void)
 {
@@ -41,21 +46,71 @@ dlist_t *DListCreate(void)
 	(new_dlist->tail).data = NULL;
 	(new_dlist->head).next = &(new_dlist->tail);
 	(new_dlist->tail).prev = &(new_dlist->head);
+	new_dlist->is_intrusive = 0;
+	new_dlist->pool = NULL;
+	new_dlist->is_pool_owned = 0;
+	new_dlist->size = 0;
 	
 	return new_dlist;	
 	 
 }
 
+dlist_t *DListCreateIntrusive(void)
+{
+	dlist_t *new_dlist = DListCreate();
+	
+	if(NULL != new_dlist)
+	{
+		new_dlist->is_intrusive = 1;
+	}
+	
+	return new_dlist;
+}
+
+dlist_t *DListCreatePooled(fsa_pool_t *pool)
+{
+	dlist_t *new_dlist = NULL;
+	
+	assert(NULL == pool || sizeof(node_t) <= FSAPoolBlockSize(pool));
+	
+	new_dlist = DListCreate();
+	if(NULL == new_dlist)
+	{
+		return NULL;
+	}
+	
+	new_dlist->pool = pool;
+	
+	if(NULL == pool)
+	{
+		new_dlist->pool = FSAPoolCreate(sizeof(node_t), LIST_POOL_BLOCKS);
+		if(NULL == new_dlist->pool)
+		{
+			free(new_dlist);
+			return NULL;
+		}
+		new_dlist->is_pool_owned = 1;
+	}
+	
+	return new_dlist;
+}
+
 void DListDestroy(dlist_t *list)
 {
 	
 	assert(NULL != list);
 	
-	while(0 == DListIsEmpty(list))
+	/* the nodes of an intrusive list belong to the caller */
+	while(!list->is_intrusive && 0 == DListIsEmpty(list))
 	{
 		DListRemove(list, DListBegin(list));
 	}
 	
+	if(list->is_pool_owned)
+	{
+		FSAPoolDestroy(list->pool);
+	}
+	
 	free(list);
 
 }
@@ -92,26 +147,60 @@ dlist_iter_t DListInsert(dlist_t *list, dlist_iter_t next_iterator, const void *
 	assert(NULL != list);
 	assert(NULL != next_iterator.internal);
 	assert(NULL != data);
+	assert(!list->is_intrusive);
 	
-	new_node = (node_t*)malloc(sizeof(node_t));
+	new_node = AllocNode(list);
 	
 	if(NULL == new_node)
 	{
 		return DListEnd(list);
 	}
 	
-	new_node->data = (void *)data;
-	new_node->prev = (next_iterator.internal)->prev;
-	new_node->next = next_iterator.internal;
+	Link(next_iterator.internal, new_node, data);
+	++list->size;
 	new_iter.internal = new_node;
 	
-	((next_iterator.internal)->prev)->next = new_node;
-	(next_iterator.internal->prev) = new_node;
-	
 	return new_iter;
 		 
 }
 
+dlist_iter_t DListInsertNode(dlist_t *list, dlist_iter_t next_iterator,
+                             dlist_node_t *node, const void *data)
+{
+	dlist_iter_t new_iter = {NULL};
+	
+	assert(NULL != list);
+	assert(NULL != next_iterator.internal);
+	assert(NULL != node);
+	assert(NULL != data);
+	assert(list->is_intrusive);
+	
+	Link(next_iterator.internal, node, data);
+	++list->size;
+	new_iter.internal = node;
+	
+	return new_iter;
+}
+
+dlist_iter_t DListPushBackNode(dlist_t *list, dlist_node_t *node,
+                               const void *data)
+{
+	assert(NULL != list);
+	
+	return DListInsertNode(list, DListEnd(list), node, data);
+}
+
+dlist_iter_t DListNodeToIter(dlist_node_t *node)
+{
+	dlist_iter_t iter = {NULL};
+	
+	assert(NULL != node);
+	
+	iter.internal = node;
+	
+	return iter;
+}
+
 dlist_iter_t DListRemove(dlist_t *list, dlist_iter_t iterator)
 {
 	dlist_iter_t next_iterator = {NULL};
@@ -120,10 +209,13 @@ dlist_iter_t DListRemove(dlist_t *list, dlist_iter_t iterator)
 	assert(NULL != iterator.internal);
 	
 	next_iterator.internal = iterator.internal->next;
-	(iterator.internal->next)->prev = iterator.internal->prev;
-	(iterator.internal->prev)->next = iterator.internal->next;
+	Unlink(iterator.internal);
+	--list->size;
 	
-	free(iterator.internal);
+	if(!list->is_intrusive)
+	{
+		FreeNode(list, iterator.internal);
+	}
 	return next_iterator;
 	
 }
@@ -169,18 +261,9 @@ int DListForEach(dlist_iter_t from, dlist_iter_t to, action_t func, void *param)
 
 size_t DListSize(const dlist_t *list)
 {
-	node_t *current = NULL;
-	size_t count = 0;
-	
 	assert(NULL != list);
 	
-	current = (list->head.next);
-	while(current != &(list->tail))
-	{
-		++count;
-		current = current->next;
-	}
-	return count;	
+	return list->size;	
 	
 }
 
@@ -251,11 +334,45 @@ int DListIsSameIter(dlist_iter_t iterator1, dlist_iter_t iterator2)
 	
 }
 
-dlist_iter_t DListSplice(dlist_iter_t dest_iter, dlist_iter_t from, dlist_iter_t to)
+dlist_iter_t DListSplice(dlist_t *dest_list, dlist_iter_t dest_iter,
+                         dlist_t *src_list, dlist_iter_t from, dlist_iter_t to)
+{
+	size_t count = 0;
+	
+	assert(NULL != from.internal);
+	
+	/* only a move between lists changes the sizes, the moved nodes are
+	   counted then */
+	if(dest_list != src_list)
+	{
+		count = CountRange(from.internal, to.internal);
+	}
+	
+	return DListSpliceN(dest_list, dest_iter, src_list, from, to, count);
+}
+
+dlist_iter_t DListSpliceN(dlist_t *dest_list, dlist_iter_t dest_iter,
+                          dlist_t *src_list, dlist_iter_t from,
+                          dlist_iter_t to, size_t count)
 {
 	dlist_iter_t prev_from = {NULL};
+	assert(NULL != dest_list);
+	assert(NULL != src_list);
 	assert(NULL != from.internal);
 	assert(NULL != dest_iter.internal);
+	assert(dest_list == src_list ||
+	       count == CountRange(from.internal, to.internal));
+	
+	if(from.internal == to.internal)
+	{
+		return dest_iter;
+	}
+	
+	if(dest_list != src_list)
+	{
+		src_list->size -= count;
+		dest_list->size += count;
+	}
 	
 	prev_from.internal = (from.internal)->prev;
 	
@@ -298,4 +415,53 @@ int DListMultiFind(dlist_iter_t from, dlist_iter_t to, is_match_t is_match,
 	
 }
 
+/*----------------------------------------------------------------------------*/
+
+static void Link(node_t *next, node_t *new_node, const void *data)
+{
+	new_node->data = (void *)data;
+	new_node->prev = next->prev;
+	new_node->next = next;
+	
+	(next->prev)->next = new_node;
+	next->prev = new_node;
+}
+
+static void Unlink(node_t *node)
+{
+	(node->next)->prev = node->prev;
+	(node->prev)->next = node->next;
+}
+
+static node_t *AllocNode(dlist_t *list)
+{
+	if(NULL != list->pool)
+	{
+		return (node_t *)FSAPoolAlloc(list->pool);
+	}
+	
+	return (node_t *)malloc(sizeof(node_t));
+}
+
+static void FreeNode(dlist_t *list, node_t *node)
+{
+	if(NULL != list->pool)
+	{
+		FSAPoolFree(list->pool, node);
+		return;
+	}
+	
+	free(node);
+}
 
+static size_t CountRange(const node_t *from, const node_t *to)
+{
+	size_t count = 0;
+	
+	for(; from != to; from = from->next)
+	{
+		++count;
+	}
+	
+	return count;
+}
@@ -0,0 +1,167 @@
+/********************************************
+File name : hash_functions.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <assert.h>	/* assert */
+#include <string.h>	/* memcpy, strlen */
+
+#include "hash_functions.h" /* hash functions API */
+
+/* xxHash64 primes */
+#define PRIME1 ((size_t)0x9E3779B185EBCA87UL)
+#define PRIME2 ((size_t)0xC2B2AE3D27D4EB4FUL)
+#define PRIME3 ((size_t)0x165667B19E3779F9UL)
+#define PRIME4 ((size_t)0x85EBCA77C2B2AE63UL)
+#define PRIME5 ((size_t)0x27D4EB2F165667C5UL)
+#define STRIPE_SIZE (32)
+
+/* the constants and Read8 need a 64 bit size_t, the build fails here on a
+   narrower one */
+typedef char size_t_is_64_bits[(8 == sizeof(size_t)) ? 1 : -1];
+
+static size_t Rotl(size_t word, unsigned int bits);
+static size_t Read8(const unsigned char *bytes);
+static size_t Read4(const unsigned char *bytes);
+static size_t Round(size_t acc, size_t input);
+static size_t Merge(size_t acc, size_t val);
+
+/*----------------------------------------------------------------------------*/
+
+size_t HashBytes(const void *bytes, size_t len, size_t seed)
+{
+	const unsigned char *runner = (const unsigned char *)bytes;
+	const unsigned char *end = runner + len;
+	size_t hash = 0;
+
+	assert(NULL != bytes || 0 == len);
+
+	if(STRIPE_SIZE <= len)
+	{
+		const unsigned char *last_stripe = end - STRIPE_SIZE;
+		size_t v1 = seed + PRIME1 + PRIME2;
+		size_t v2 = seed + PRIME2;
+		size_t v3 = seed;
+		size_t v4 = seed - PRIME1;
+
+		do
+		{
+			v1 = Round(v1, Read8(runner));
+			v2 = Round(v2, Read8(runner + 8));
+			v3 = Round(v3, Read8(runner + 16));
+			v4 = Round(v4, Read8(runner + 24));
+			runner += STRIPE_SIZE;
+		}
+		while(runner <= last_stripe);
+
+		hash = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+		hash = Merge(hash, v1);
+		hash = Merge(hash, v2);
+		hash = Merge(hash, v3);
+		hash = Merge(hash, v4);
+	}
+	else
+	{
+		hash = seed + PRIME5;
+	}
+
+	hash += len;
+
+	for(; runner + 8 <= end; runner += 8)
+	{
+		hash ^= Round(0, Read8(runner));
+		hash = Rotl(hash, 27) * PRIME1 + PRIME4;
+	}
+
+	if(runner + 4 <= end)
+	{
+		hash ^= Read4(runner) * PRIME1;
+		hash = Rotl(hash, 23) * PRIME2 + PRIME3;
+		runner += 4;
+	}
+
+	for(; runner < end; ++runner)
+	{
+		hash ^= *runner * PRIME5;
+		hash = Rotl(hash, 11) * PRIME1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= PRIME2;
+	hash ^= hash >> 29;
+	hash *= PRIME3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+size_t HashInt(size_t key)
+{
+	key ^= key >> 33;
+	key *= (size_t)0xFF51AFD7ED558CCDUL;
+	key ^= key >> 33;
+	key *= (size_t)0xC4CEB9FE1A85EC53UL;
+	key ^= key >> 33;
+
+	return key;
+}
+
+size_t HashString(const void *data)
+{
+	assert(NULL != data);
+
+	return HashBytes(data, strlen((const char *)data), 0);
+}
+
+size_t HashSizeT(const void *data)
+{
+	assert(NULL != data);
+
+	return HashInt(*(const size_t *)data);
+}
+
+/*----------------------------------------------------------------------------*/
+
+static size_t Rotl(size_t word, unsigned int bits)
+{
+	return (word << bits) | (word >> (sizeof(size_t) * 8 - bits));
+}
+
+/* memcpy is safe for any alignment and compiles to a single load */
+static size_t Read8(const unsigned char *bytes)
+{
+	size_t word = 0;
+
+	memcpy(&word, bytes, 8);
+
+	return word;
+}
+
+static size_t Read4(const unsigned char *bytes)
+{
+	unsigned int word = 0;
+
+	memcpy(&word, bytes, 4);
+
+	return word;
+}
+
+static size_t Round(size_t acc, size_t input)
+{
+	acc += input * PRIME2;
+	acc = Rotl(acc, 31);
+
+	return acc * PRIME1;
+}
+
+static size_t Merge(size_t acc, size_t val)
+{
+	acc ^= Round(0, val);
+
+	return acc * PRIME1 + PRIME4;
+}
@@ -0,0 +1,484 @@
+/********************************************
+File name : hash_snapshot.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+#define _POSIX_C_SOURCE 200809L	/* open, fstat, mmap, mkstemp, fsync */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <assert.h>	/* assert */
+#include <stdlib.h>	/* malloc, calloc, free, mkstemp */
+#include <stdio.h>	/* fdopen, fwrite, fflush, fclose, rename, remove */
+#include <string.h>	/* memcmp, memcpy, memset, strlen, strcpy, strcat */
+#include <limits.h>	/* CHAR_BIT */
+#include <fcntl.h>	/* open */
+#include <unistd.h>	/* close, fsync */
+#include <sys/stat.h>	/* fstat, fchmod */
+#include <sys/mman.h>	/* mmap, munmap */
+
+#include "hash_table.h" /* hash table API */
+#include "hash_snapshot.h" /* hash snapshot API */
+
+#define SNAP_MAGIC ("HTSNAP1")
+#define SNAP_MAGIC_SIZE (8)
+/* reads back differently on a machine with another byte order */
+#define SNAP_BYTE_ORDER ((size_t)0x0102030405060708UL)
+#define SNAP_MIN_BUCKETS (8)
+#define SNAP_SIZE_BITS (sizeof(size_t) * CHAR_BIT)
+/* 2^64 / golden ratio - spreads the user hash over the high bits */
+#define SNAP_FIB_MULT ((size_t)0x9E3779B97F4A7C15UL)
+/* mkstemp replaces the X's, the file is next to path so rename does not
+   cross file systems */
+#define SNAP_TMP_SUFFIX (".XXXXXX")
+/* mkstemp creates the file readable only by the owner */
+#define SNAP_FILE_MODE (S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)
+#define ALIGN(size) (((size) + sizeof(size_t) - 1) & ~(sizeof(size_t) - 1))
+
+/* SNAP_BYTE_ORDER and SNAP_FIB_MULT need a 64 bit size_t, the build fails
+   here on a narrower one */
+typedef char size_t_is_64_bits[(8 == sizeof(size_t)) ? 1 : -1];
+
+typedef struct snap_header
+{
+	char magic[SNAP_MAGIC_SIZE];
+	size_t byte_order;
+	size_t n_buckets;
+	size_t shift;
+	size_t n_entries;
+	size_t buckets_offset;
+	size_t entries_offset;
+	size_t file_size;
+} snap_header_t;
+
+typedef struct snap_entry
+{
+	size_t hash;
+	size_t offset;
+	size_t len;
+} snap_entry_t;
+
+struct hash_snapshot
+{
+	const char *base;
+	size_t map_size;
+	const snap_header_t *header;
+	hash_function_t hash_func;
+	snap_is_match_t is_match;
+};
+
+/* the entries of the table while saving */
+typedef struct save_item
+{
+	const void *data;
+	size_t hash;
+	size_t len;
+	size_t bucket;
+} save_item_t;
+
+typedef struct save
+{
+	snap_header_t header;
+	save_item_t *items;
+	size_t count;
+	size_t *starts;
+	size_t *order;
+	snap_encode_t encode;
+	void *param;
+} save_t;
+
+static void InitHeader(snap_header_t *header, size_t n);
+static int Collect(void *data, void *param);
+static void Layout(save_t *save, hash_function_t hash_func);
+static size_t Bucket(size_t hash, size_t shift);
+static int WriteFile(FILE *file, const save_t *save);
+static int IsValidHeader(const snap_header_t *header, size_t map_size);
+static const void *GetRecord(const hash_snapshot_t *snap,
+                             const snap_entry_t *entry);
+static const size_t *GetStarts(const hash_snapshot_t *snap);
+static const snap_entry_t *GetEntries(const hash_snapshot_t *snap);
+
+/*----------------------------------------------------------------------------*/
+
+int HashSnapshotSave(const hash_table_t *table, const char *path,
+                     hash_function_t hash_func, snap_encode_t encode,
+                     void *param)
+{
+	save_t save;
+	char *tmp_path = NULL;
+	size_t n = 0;
+	int res = 1;
+
+	assert(NULL != table);
+	assert(NULL != path);
+	assert(NULL != hash_func);
+	assert(NULL != encode);
+
+	n = HashTableSize(table);
+	InitHeader(&save.header, n);
+	save.encode = encode;
+	save.param = param;
+	save.count = 0;
+	save.items = NULL;
+	save.order = NULL;
+
+	/* malloc(0) may return NULL, an empty table is saved without them */
+	if(0 != n)
+	{
+		save.items = (save_item_t *)malloc(sizeof(save_item_t) * n);
+		save.order = (size_t *)malloc(sizeof(size_t) * n);
+	}
+	save.starts = (size_t *)calloc(save.header.n_buckets + 1, sizeof(size_t));
+	tmp_path = (char *)malloc(strlen(path) + sizeof(SNAP_TMP_SUFFIX));
+
+	if((0 == n || (NULL != save.items && NULL != save.order)) &&
+	   NULL != save.starts && NULL != tmp_path)
+	{
+		FILE *file = NULL;
+		int fd = -1;
+
+		HashTableForEach(table, Collect, &save);
+		assert(n == save.count);
+		Layout(&save, hash_func);
+
+		strcpy(tmp_path, path);
+		strcat(tmp_path, SNAP_TMP_SUFFIX);
+
+		/* a unique name per save, two concurrent saves to the same path do
+		   not write into the same file */
+		fd = mkstemp(tmp_path);
+		file = (-1 == fd) ? NULL : fdopen(fd, "wb");
+		if(NULL == file && -1 != fd)
+		{
+			close(fd);
+			remove(tmp_path);
+		}
+
+		if(NULL != file)
+		{
+			res = (0 != fchmod(fd, SNAP_FILE_MODE));
+			res = res || WriteFile(file, &save);
+			/* the data must be on disk before the rename is, or a crash can
+			   leave path naming an empty or partial file */
+			res = res || (0 != fflush(file)) || (0 != fsync(fd));
+			res = (0 != fclose(file)) || res;
+			res = res || (0 != rename(tmp_path, path));
+			if(0 != res)
+			{
+				remove(tmp_path);
+			}
+		}
+	}
+
+	free(tmp_path);
+	free(save.order);
+	free(save.starts);
+	free(save.items);
+
+	return res;
+}
+
+hash_snapshot_t *HashSnapshotOpen(const char *path, hash_function_t hash_func,
+                                  snap_is_match_t is_match)
+{
+	hash_snapshot_t *snap = NULL;
+	struct stat file_stat;
+	void *base = NULL;
+	int fd = 0;
+
+	assert(NULL != path);
+	assert(NULL != hash_func);
+	assert(NULL != is_match);
+
+	fd = open(path, O_RDONLY);
+	if(-1 == fd)
+	{
+		return NULL;
+	}
+
+	if(0 != fstat(fd, &file_stat) ||
+	   (size_t)file_stat.st_size < sizeof(snap_header_t))
+	{
+		close(fd);
+		return NULL;
+	}
+
+	/* the mapping stays valid after the descriptor is closed */
+	base = mmap(NULL, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if(MAP_FAILED == base)
+	{
+		return NULL;
+	}
+
+	snap = (hash_snapshot_t *)malloc(sizeof(hash_snapshot_t));
+	if(NULL == snap ||
+	   !IsValidHeader((const snap_header_t *)base, file_stat.st_size))
+	{
+		free(snap);
+		munmap(base, file_stat.st_size);
+		return NULL;
+	}
+
+	snap->base = (const char *)base;
+	snap->map_size = file_stat.st_size;
+	snap->header = (const snap_header_t *)base;
+	snap->hash_func = hash_func;
+	snap->is_match = is_match;
+
+	return snap;
+}
+
+void HashSnapshotClose(hash_snapshot_t *snap)
+{
+	assert(NULL != snap);
+
+	munmap((void *)snap->base, snap->map_size);
+	free(snap); snap = NULL;
+}
+
+const void *HashSnapshotFind(const hash_snapshot_t *snap, const void *key,
+                             size_t *len)
+{
+	const size_t *starts = NULL;
+	const snap_entry_t *entries = NULL;
+	size_t hash = 0;
+	size_t bucket = 0;
+	size_t idx = 0;
+	size_t end = 0;
+
+	assert(NULL != snap);
+	assert(NULL != key);
+
+	starts = GetStarts(snap);
+	entries = GetEntries(snap);
+	hash = snap->hash_func(key);
+	bucket = Bucket(hash, snap->header->shift);
+
+	idx = starts[bucket];
+	end = starts[bucket + 1];
+	end = (end > snap->header->n_entries) ? snap->header->n_entries : end;
+
+	for(; idx < end; ++idx)
+	{
+		const void *record = GetRecord(snap, &entries[idx]);
+
+		if(hash == entries[idx].hash && NULL != record &&
+		   snap->is_match(record, entries[idx].len, key))
+		{
+			if(NULL != len)
+			{
+				*len = entries[idx].len;
+			}
+			return record;
+		}
+	}
+
+	return NULL;
+}
+
+size_t HashSnapshotSize(const hash_snapshot_t *snap)
+{
+	assert(NULL != snap);
+
+	return snap->header->n_entries;
+}
+
+int HashSnapshotForEach(const hash_snapshot_t *snap, snap_action_t action,
+                        void *param)
+{
+	const snap_entry_t *entries = NULL;
+	size_t idx = 0;
+	int res = 0;
+
+	assert(NULL != snap);
+	assert(NULL != action);
+
+	entries = GetEntries(snap);
+
+	for(; idx < snap->header->n_entries && 0 == res; ++idx)
+	{
+		const void *record = GetRecord(snap, &entries[idx]);
+
+		if(NULL != record)
+		{
+			res = action(record, entries[idx].len, param);
+		}
+	}
+
+	return res;
+}
+
+/*----------------------------------------------------------------------------*/
+
+static void InitHeader(snap_header_t *header, size_t n)
+{
+	memset(header, 0, sizeof(snap_header_t));
+	memcpy(header->magic, SNAP_MAGIC, sizeof(SNAP_MAGIC));
+	header->byte_order = SNAP_BYTE_ORDER;
+	header->n_buckets = 1;
+	header->shift = SNAP_SIZE_BITS;
+	while(header->n_buckets < n || header->n_buckets < SNAP_MIN_BUCKETS)
+	{
+		header->n_buckets *= 2;
+		--header->shift;
+	}
+	header->n_entries = n;
+	header->buckets_offset = sizeof(snap_header_t);
+	header->entries_offset = header->buckets_offset +
+	                         (header->n_buckets + 1) * sizeof(size_t);
+	header->file_size = header->entries_offset + n * sizeof(snap_entry_t);
+}
+
+static int Collect(void *data, void *param)
+{
+	save_t *save = (save_t *)param;
+
+	save->items[save->count].data = data;
+	++save->count;
+
+	return 0;
+}
+
+/* counting sort by bucket: starts[b + 1] counts bucket b, then the prefix
+   sums give where every bucket begins. order lists the items by bucket. */
+static void Layout(save_t *save, hash_function_t hash_func)
+{
+	snap_header_t *header = &save->header;
+	size_t *starts = save->starts;
+	size_t idx = 0;
+
+	for(idx = 0; idx < header->n_entries; ++idx)
+	{
+		save_item_t *item = &save->items[idx];
+
+		item->hash = hash_func(item->data);
+		item->bucket = Bucket(item->hash, header->shift);
+		item->len = save->encode(item->data, NULL, 0, save->param);
+		header->file_size += ALIGN(item->len);
+		++starts[item->bucket + 1];
+	}
+
+	for(idx = 0; idx < header->n_buckets; ++idx)
+	{
+		starts[idx + 1] += starts[idx];
+	}
+
+	/* starts[b] is used as the fill position of bucket b and ends up at the
+	   beginning of bucket b + 1, shifting it back restores it */
+	for(idx = 0; idx < header->n_entries; ++idx)
+	{
+		save->order[starts[save->items[idx].bucket]++] = idx;
+	}
+	for(idx = header->n_buckets; 0 < idx; --idx)
+	{
+		starts[idx] = starts[idx - 1];
+	}
+	starts[0] = 0;
+}
+
+static size_t Bucket(size_t hash, size_t shift)
+{
+	return (hash * SNAP_FIB_MULT) >> shift;
+}
+
+static int WriteFile(FILE *file, const save_t *save)
+{
+	const snap_header_t *header = &save->header;
+	size_t offset = header->entries_offset +
+	                header->n_entries * sizeof(snap_entry_t);
+	size_t max_len = 0;
+	char *buf = NULL;
+	size_t idx = 0;
+	int res = 0;
+
+	if(1 != fwrite(header, sizeof(snap_header_t), 1, file) ||
+	   header->n_buckets + 1 != fwrite(save->starts, sizeof(size_t),
+	                                   header->n_buckets + 1, file))
+	{
+		return 1;
+	}
+
+	for(idx = 0; idx < header->n_entries; ++idx)
+	{
+		const save_item_t *item = &save->items[save->order[idx]];
+		snap_entry_t entry;
+
+		entry.hash = item->hash;
+		entry.offset = offset;
+		entry.len = item->len;
+		if(1 != fwrite(&entry, sizeof(snap_entry_t), 1, file))
+		{
+			return 1;
+		}
+
+		offset += ALIGN(item->len);
+		max_len = (item->len > max_len) ? item->len : max_len;
+	}
+
+	buf = (char *)malloc(ALIGN(max_len) + 1);
+	if(NULL == buf)
+	{
+		return 1;
+	}
+
+	for(idx = 0; idx < header->n_entries && 0 == res; ++idx)
+	{
+		const save_item_t *item = &save->items[save->order[idx]];
+
+		memset(buf, 0, ALIGN(item->len));
+		res = (item->len != save->encode(item->data, buf, item->len,
+		                                 save->param)) ||
+		      (ALIGN(item->len) != fwrite(buf, 1, ALIGN(item->len), file));
+	}
+
+	free(buf);
+
+	return res;
+}
+
+/* checks what every lookup relies on without reading the rest of the file,
+   the ranges of a single entry are checked when it is used */
+static int IsValidHeader(const snap_header_t *header, size_t map_size)
+{
+	size_t max_count = map_size / sizeof(size_t);
+
+	return (0 == memcmp(header->magic, SNAP_MAGIC, sizeof(SNAP_MAGIC)) &&
+	        SNAP_BYTE_ORDER == header->byte_order &&
+	        map_size == header->file_size &&
+	        0 < header->shift && SNAP_SIZE_BITS > header->shift &&
+	        header->n_buckets ==
+	            (size_t)1 << (SNAP_SIZE_BITS - header->shift) &&
+	        header->n_buckets < max_count &&
+	        header->n_entries <= max_count &&
+	        sizeof(snap_header_t) == header->buckets_offset &&
+	        header->entries_offset == header->buckets_offset +
+	            (header->n_buckets + 1) * sizeof(size_t) &&
+	        header->entries_offset +
+	            header->n_entries * sizeof(snap_entry_t) <= map_size);
+}
+
+static const void *GetRecord(const hash_snapshot_t *snap,
+                             const snap_entry_t *entry)
+{
+	if(entry->offset > snap->map_size ||
+	   entry->len > snap->map_size - entry->offset)
+	{
+		return NULL;
+	}
+
+	return snap->base + entry->offset;
+}
+
+static const size_t *GetStarts(const hash_snapshot_t *snap)
+{
+	return (const size_t *)(snap->base + snap->header->buckets_offset);
+}
+
+static const snap_entry_t *GetEntries(const hash_snapshot_t *snap)
+{
+	return (const snap_entry_t *)(snap->base + snap->header->entries_offset);
+}
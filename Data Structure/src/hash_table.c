@@ -10,19 +10,78 @@ Infinity Labs OL95
 #include <stdio.h> /*printf*/
 #include <sys/types.h>  /*ssize_t*/
 #include <math.h>
+#include <limits.h> /* CHAR_BIT */
 #include "hash_table.h"
 #include "doubly_linked_list.h"
+#include "rh_table.h"
 #include "utilities.h"
 
-
+#define HASH_DEFAULT_MAX_LOAD (1.0)
+#define HASH_MIN_TABLE_SIZE (8)
+#define HASH_SIZE_BITS (sizeof(size_t) * CHAR_BIT)
+/* 2^64 / golden ratio - spreads the user hash over the high bits */
+#define HASH_FIB_MULT ((size_t)0x9E3779B97F4A7C15UL)
+/* min buckets of the old array moved by one insert / remove while growing */
+#define HASH_REHASH_STEP (4)
+/* keys of HashTableFindBatch handled together, enough cache misses in
+   flight to hide the memory latency */
+#define HASH_BATCH (16)
+
+#ifdef __GNUC__
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) ((void)(addr))
+#endif
+
+/* HASH_FIB_MULT needs a 64 bit size_t, the build fails here on a
+   narrower one */
+typedef char size_t_is_64_bits[(8 == sizeof(size_t)) ? 1 : -1];
+
+/* chaining: the lists are intrusive, every hash_entry_t holds its own list
+   node, so an insert allocates once. The full hash is compared before
+   match_func is called. A bucket is NULL until an entry lands in it. While
+   growing, old_arr holds the previous buckets, every bucket below cursor
+   was already moved to arr. The number of buckets is a power of two, the
+   bucket is picked by the top bits of hash * golden ratio (shift), which
+   needs no division and does not depend on the quality of the low bits. */
 struct hash_table
 {
+    hash_backend_t backend;
     dlist_t **arr;
+    dlist_t **old_arr;
+    rh_table_t *rh_table;
     hash_function_t hash_func;
     is_match_t match_func;
     size_t table_size;
+    size_t old_size;
+    size_t shift;
+    size_t old_shift;
+    size_t cursor;
+    size_t size;
+    size_t used_buckets;
+    double max_load;
 };
 
+typedef struct hash_entry
+{
+    dlist_node_t node;
+    size_t hash;
+    void *data;
+} hash_entry_t;
+
+typedef struct entry_key
+{
+    size_t hash;
+    const void *key;
+    is_match_t match_func;
+} entry_key_t;
+
+typedef struct entry_action
+{
+    hash_action_t action;
+    void *param;
+} entry_action_t;
+
 int PrintListString(void * data, void *param)
 {
     (void)param;
@@ -30,69 +89,256 @@ int PrintListString(void * data, void *param)
     return 0;
 }
 
-static int CountSize(void *node, void *param)
+static int IsEntryMatch(const void *entry, const void *key)
 {
-    assert(NULL != node);
-    
-    *(int *)param += 1;
-    return 0;
+    const hash_entry_t *hash_entry = (const hash_entry_t *)entry;
+    const entry_key_t *entry_key = (const entry_key_t *)key;
+
+    return ((hash_entry->hash == entry_key->hash) &&
+            entry_key->match_func(hash_entry->data, entry_key->key));
+}
+
+static int EntryAction(void *entry, void *param)
+{
+    entry_action_t *entry_action = (entry_action_t *)param;
+
+    return entry_action->action(((hash_entry_t *)entry)->data,
+                                entry_action->param);
 }
 
-static size_t GetKey(const hash_table_t *hash_table, const void *data)
+static dlist_t **GetBucket(dlist_t **arr, size_t shift, size_t hash)
 {
-    return ((hash_table->hash_func(data)) % (hash_table->table_size));
+    return (arr + ((hash * HASH_FIB_MULT) >> shift));
 }
 
-static void DestroyHashTableBySize(hash_table_t *hash_table, size_t size)
+static void DestroyBuckets(dlist_t **arr, size_t size)
 {
     size_t idx = 0;
     for(; idx < size; ++idx)
     {
-        DListDestroy(hash_table->arr[idx]);
+        if(NULL != arr[idx])
+        {
+            while(!(DListIsEmpty(arr[idx])))
+            {
+                void *entry = DListGetData(DListBegin(arr[idx]));
+
+                DListRemove(arr[idx], DListBegin(arr[idx]));
+                free(entry);
+            }
+            DListDestroy(arr[idx]);
+        }
     }
-    free(hash_table->arr);
-    free(hash_table);
-    hash_table = NULL;
+    free(arr);
+}
 
+static int IsGrowing(const hash_table_t *hash_table)
+{
+    return (NULL != hash_table->old_arr);
 }
 
-static hash_table_t *InitHashTable(hash_table_t *hash_table, size_t table_size)
+/* returns the list that holds data and sets iter to its node,
+   NULL if not found. hash is the hash of data. */
+static dlist_t *FindNode(const hash_table_t *hash_table, const void *data,
+                         size_t hash, dlist_iter_t *iter)
 {
+    dlist_t *lists[2] = {NULL};
+    entry_key_t key = {0};
     size_t idx = 0;
-    for(idx = 0; idx < table_size ; ++idx)
+
+    key.hash = hash;
+    key.key = data;
+    key.match_func = hash_table->match_func;
+
+    lists[0] = *GetBucket(hash_table->arr, hash_table->shift, key.hash);
+    if(IsGrowing(hash_table))
+    {
+        lists[1] = *GetBucket(hash_table->old_arr, hash_table->old_shift,
+                              key.hash);
+    }
+
+    for(; idx < 2; ++idx)
     {
-        hash_table->arr[idx] = DListCreate();
+        dlist_t *list = lists[idx];
 
-        if (NULL == hash_table->arr[idx])
+        if(NULL != list)
         {
-            DestroyHashTableBySize(hash_table, idx);
-            return NULL;
+            *iter = DListFind(DListBegin(list), DListEnd(list),
+                              IsEntryMatch, &key);
+            if(!(DListIsSameIter(*iter, DListEnd(list))))
+            {
+                return list;
+            }
         }
     }
 
-    return hash_table;
+    return NULL;
+}
+
+/* moves the nodes of one old bucket to arr by their stored hash, no node
+   is allocated and the hash function is not called.
+   Fails only if a new bucket list can not be created. */
+static int MoveBucket(hash_table_t *hash_table, size_t idx)
+{
+    dlist_t *list = hash_table->old_arr[idx];
+    int is_used = 0;
+
+    if(NULL == list)
+    {
+        return 0;
+    }
+
+    is_used = !(DListIsEmpty(list));
+    while(!(DListIsEmpty(list)))
+    {
+        dlist_iter_t iter = DListBegin(list);
+        hash_entry_t *entry = (hash_entry_t *)DListGetData(iter);
+        dlist_t **bucket = GetBucket(hash_table->arr, hash_table->shift,
+                                     entry->hash);
+
+        if(NULL == *bucket && NULL == (*bucket = DListCreateIntrusive()))
+        {
+            return 1;
+        }
+        hash_table->used_buckets += DListIsEmpty(*bucket);
+        DListSpliceN(*bucket, DListEnd(*bucket), list, iter,
+                     DListNextIter(iter), 1);
+    }
+
+    hash_table->used_buckets -= is_used;
+    DListDestroy(list);
+    hash_table->old_arr[idx] = NULL;
+
+    return 0;
+}
+
+static void MigrateStep(hash_table_t *hash_table, size_t steps)
+{
+    for(; IsGrowing(hash_table) && 0 < steps; --steps)
+    {
+        if(hash_table->cursor == hash_table->old_size)
+        {
+            free(hash_table->old_arr);
+            hash_table->old_arr = NULL;
+            hash_table->old_size = 0;
+        }
+        else if(0 == MoveBucket(hash_table, hash_table->cursor))
+        {
+            ++hash_table->cursor;
+        }
+        else
+        {
+            return;
+        }
+    }
+}
+
+/* buckets to move by one insert / remove: the buckets left spread over
+   the inserts that still fit under the max load, so the growth is done
+   before the load reaches the next one (also after a lower max load is
+   set) and no insert moves the whole table */
+static size_t RehashSteps(const hash_table_t *hash_table)
+{
+    double room = 0;
+    size_t inserts = 0;
+    size_t left = 0;
+    size_t steps = 0;
+
+    if(!IsGrowing(hash_table))
+    {
+        return 0;
+    }
+
+    /* + 1 for the step that frees the old array */
+    left = hash_table->old_size - hash_table->cursor + 1;
+    room = hash_table->max_load * hash_table->table_size - hash_table->size;
+    inserts = (1 > room) ? 0 : (size_t)room;
+    steps = (0 == inserts) ? left : (left + inserts - 1) / inserts;
+
+    return (steps < HASH_REHASH_STEP) ? HASH_REHASH_STEP : steps;
+}
+
+/* starts moving the buckets to an array twice as big. The previous growth
+   was completed by RehashSteps before the load got here. */
+static int Grow(hash_table_t *hash_table)
+{
+    dlist_t **new_arr = NULL;
+
+    assert(!IsGrowing(hash_table));
+
+    new_arr = (dlist_t **)calloc(hash_table->table_size * 2, sizeof(dlist_t *));
+    if(NULL == new_arr)
+    {
+        return 1;
+    }
+
+    hash_table->old_arr = hash_table->arr;
+    hash_table->old_size = hash_table->table_size;
+    hash_table->old_shift = hash_table->shift;
+    hash_table->cursor = 0;
+    hash_table->arr = new_arr;
+    hash_table->table_size *= 2;
+    --hash_table->shift;
+
+    return 0;
 }
 
 /*----------------------------------------------------------------------------*/
 
 hash_table_t *HashTableCreate(size_t table_size, hash_function_t hash_func, is_match_hash_t match_func)
+{
+    return HashTableCreateBackend(table_size, hash_func, match_func,
+                                  HASH_DEFAULT_BACKEND);
+}
+
+/*----------------------------------------------------------------------------*/
+
+hash_table_t *HashTableCreateBackend(size_t table_size, hash_function_t hash_func, is_match_hash_t match_func, hash_backend_t backend)
 {
     hash_table_t *hash_table = NULL;
 
     assert(NULL != hash_func);
     assert(NULL != match_func);
+    assert(0 < table_size);
 
     hash_table = (hash_table_t *)malloc(sizeof(hash_table_t));
     MALLOC_CHECK(hash_table, HashTableCreate);
 
-    hash_table->arr = malloc(sizeof(dlist_t *) * table_size);
-    MALLOC_CHECK_FREE(hash_table->arr, HashTableCreate, hash_table);
-
+    hash_table->backend = backend;
+    hash_table->arr = NULL;
+    hash_table->old_arr = NULL;
+    hash_table->rh_table = NULL;
     hash_table->hash_func = hash_func;
     hash_table->match_func = match_func;
     hash_table->table_size = table_size;
+    hash_table->old_size = 0;
+    hash_table->shift = HASH_SIZE_BITS;
+    hash_table->old_shift = 0;
+    hash_table->cursor = 0;
+    hash_table->size = 0;
+    hash_table->used_buckets = 0;
+    hash_table->max_load = HASH_DEFAULT_MAX_LOAD;
+
+    if(HASH_OPEN_ADDRESSING == backend)
+    {
+        hash_table->rh_table = RHTableCreate(table_size, hash_func, match_func);
+        MALLOC_CHECK_FREE(hash_table->rh_table, HashTableCreate, hash_table);
+
+        return hash_table;
+    }
 
-    return InitHashTable(hash_table, table_size);
+    hash_table->table_size = 1;
+    while(hash_table->table_size < table_size ||
+          hash_table->table_size < HASH_MIN_TABLE_SIZE)
+    {
+        hash_table->table_size *= 2;
+        --hash_table->shift;
+    }
+
+    hash_table->arr = (dlist_t **)calloc(hash_table->table_size,
+                                         sizeof(dlist_t *));
+    MALLOC_CHECK_FREE(hash_table->arr, HashTableCreate, hash_table);
+
+    return hash_table;
 }
 
 /*----------------------------------------------------------------------------*/
@@ -101,25 +347,75 @@ void HashTableDestroy(hash_table_t *hash_table)
 {
     assert(NULL != hash_table);
 
-    DestroyHashTableBySize(hash_table, hash_table->table_size);
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        RHTableDestroy(hash_table->rh_table);
+        free(hash_table);
+        return;
+    }
+
+    if(IsGrowing(hash_table))
+    {
+        DestroyBuckets(hash_table->old_arr, hash_table->old_size);
+    }
+    DestroyBuckets(hash_table->arr, hash_table->table_size);
+    free(hash_table);
+    hash_table = NULL;
 }
 
 /*----------------------------------------------------------------------------*/
 
 int HashTableInsert(hash_table_t *hash_table,  void *data)
 {
-    size_t data_idx = 0;
-    dlist_iter_t res = {NULL};
+    assert(NULL != hash_table);
+
+    return HashTableInsertHashed(hash_table, data, hash_table->hash_func(data));
+}
+
+int HashTableInsertHashed(hash_table_t *hash_table, void *data, size_t hash)
+{
+    dlist_t **bucket = NULL;
+    hash_entry_t *entry = NULL;
+    int is_empty = 0;
 
     assert(NULL != hash_table);
     assert(NULL != data);
 
-    data_idx = GetKey(hash_table, data);
-    res = DListPushBack(hash_table->arr[data_idx], data);
-    if(DListIsSameIter(res, DListEnd(hash_table->arr[data_idx])))
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        return RHTableInsertHashed(hash_table->rh_table, data, hash);
+    }
+
+    MigrateStep(hash_table, RehashSteps(hash_table));
+
+    /* without memory to grow, the chains just get longer. A growth is still
+       in progress here only if a bucket could not be moved (no memory) */
+    if(hash_table->size + 1 > hash_table->max_load * hash_table->table_size &&
+       !IsGrowing(hash_table))
+    {
+        Grow(hash_table);
+    }
+
+    entry = (hash_entry_t *)malloc(sizeof(hash_entry_t));
+    if(NULL == entry)
     {
         return 1;
     }
+    entry->hash = hash;
+    entry->data = data;
+
+    bucket = GetBucket(hash_table->arr, hash_table->shift, entry->hash);
+    if(NULL == *bucket && NULL == (*bucket = DListCreateIntrusive()))
+    {
+        free(entry);
+        return 1;
+    }
+
+    is_empty = DListIsEmpty(*bucket);
+    DListPushBackNode(*bucket, &entry->node, entry);
+    ++hash_table->size;
+    hash_table->used_buckets += is_empty;
+
     return 0;
 }
 
@@ -127,19 +423,36 @@ int HashTableInsert(hash_table_t *hash_table,  void *data)
 
 void HashTableRemove(hash_table_t *hash_table, const void *data)
 {
-    size_t data_idx = 0;
+    assert(NULL != hash_table);
+
+    HashTableRemoveHashed(hash_table, data, hash_table->hash_func(data));
+}
+
+void HashTableRemoveHashed(hash_table_t *hash_table, const void *data, size_t hash)
+{
     dlist_iter_t res = {NULL};
     dlist_t *list = {NULL};
 
     assert(NULL != hash_table);
     assert(NULL != data);
 
-    data_idx = GetKey(hash_table, data);
-    list = hash_table->arr[data_idx];   
-    res = DListFind(DListBegin(list), DListEnd(list),hash_table->match_func,data);
-    if(!(DListIsSameIter(res, DListEnd(list))))
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        RHTableRemoveHashed(hash_table->rh_table, data, hash);
+        return;
+    }
+
+    MigrateStep(hash_table, RehashSteps(hash_table));
+
+    list = FindNode(hash_table, data, hash, &res);
+    if(NULL != list)
     {
+        void *entry = DListGetData(res);
+
         DListRemove(list,res);
+        free(entry);
+        --hash_table->size;
+        hash_table->used_buckets -= DListIsEmpty(list);
     }
 
 }
@@ -148,75 +461,235 @@ void HashTableRemove(hash_table_t *hash_table, const void *data)
 
 void *HashTableFind(const hash_table_t *hash_table, const void *data)
 {
-    size_t data_idx = 0;
+    assert(NULL != hash_table);
+
+    return HashTableFindHashed(hash_table, data, hash_table->hash_func(data));
+}
+
+void *HashTableFindHashed(const hash_table_t *hash_table, const void *data, size_t hash)
+{
     dlist_iter_t res = {NULL};
-    dlist_t *list = {NULL};
 
     assert(NULL != hash_table);
     assert(NULL != data);
 
-    data_idx = GetKey(hash_table, data);
-    list = hash_table->arr[data_idx];   
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        return RHTableFindHashed(hash_table->rh_table, data, hash);
+    }
+
     /*DListForEach(DListBegin(list), DListEnd(list), PrintListString,NULL);*/
-    res = DListFind(DListBegin(list), DListEnd(list),hash_table->match_func, data);
-    return DListGetData(res);    
+    if(NULL == FindNode(hash_table, data, hash, &res))
+    {
+        return NULL;
+    }
+    return ((hash_entry_t *)DListGetData(res))->data;    
 }
 
 /*----------------------------------------------------------------------------*/
 
-size_t HashTableSize(const hash_table_t *hash_table)
+void HashTableFindBatch(const hash_table_t *hash_table, const void *const *keys, void **out, size_t n)
 {
-    size_t size = 0;
+    size_t hashes[HASH_BATCH] = {0};
+    size_t first = 0;
 
     assert(NULL != hash_table);
+    assert(NULL != keys || 0 == n);
+    assert(NULL != out || 0 == n);
 
-    HashTableForEach(hash_table,CountSize, &size);
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        RHTableFindBatch(hash_table->rh_table, keys, out, n);
+        return;
+    }
+
+    /* every pass over the group touches the next level of the chain that
+       the previous pass prefetched: bucket slot, list, first node */
+    for(; first < n; first += HASH_BATCH)
+    {
+        size_t count = (n - first < HASH_BATCH) ? n - first : HASH_BATCH;
+        size_t idx = 0;
+
+        for(idx = 0; idx < count; ++idx)
+        {
+            hashes[idx] = hash_table->hash_func(keys[first + idx]);
+            PREFETCH(GetBucket(hash_table->arr, hash_table->shift,
+                               hashes[idx]));
+        }
 
-    return size;
+        for(idx = 0; idx < count; ++idx)
+        {
+            dlist_t *list = *GetBucket(hash_table->arr, hash_table->shift,
+                                       hashes[idx]);
+            PREFETCH(list);
+        }
+
+        for(idx = 0; idx < count; ++idx)
+        {
+            dlist_t *list = *GetBucket(hash_table->arr, hash_table->shift,
+                                       hashes[idx]);
+            if(NULL != list)
+            {
+                PREFETCH(DListBegin(list).internal);
+            }
+        }
+
+        for(idx = 0; idx < count; ++idx)
+        {
+            dlist_iter_t res = {NULL};
+
+            assert(NULL != keys[first + idx]);
+
+            out[first + idx] = NULL;
+            if(NULL != FindNode(hash_table, keys[first + idx], hashes[idx],
+                                &res))
+            {
+                out[first + idx] = ((hash_entry_t *)DListGetData(res))->data;
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+
+size_t HashTableSize(const hash_table_t *hash_table)
+{
+    assert(NULL != hash_table);
+
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        return RHTableSize(hash_table->rh_table);
+    }
+
+    return hash_table->size;
 }
 
 /*----------------------------------------------------------------------------*/
 
 int HashTableIsEmpty(const hash_table_t *hash_table)
 {
-    size_t idx = 0;
+    assert(NULL != hash_table);
+
+    return (0 == HashTableSize(hash_table));
+}
+
+/*----------------------------------------------------------------------------*/
+
+int HashTableForEach(const hash_table_t *hash_table, hash_action_t hash_action, void *param)
+{
+    dlist_t **arrs[2] = {NULL};
+    size_t sizes[2] = {0};
+    entry_action_t entry_action = {NULL};
+    size_t arr_idx = 0;
+    int res = 0;
 
     assert(NULL != hash_table);
+    assert(NULL != hash_action);
 
-    for(; idx < hash_table->table_size; ++idx)
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
     {
-        if(!(DListIsEmpty(hash_table->arr[idx])))
+        return RHTableForEach(hash_table->rh_table, hash_action, param);
+    }
+
+    entry_action.action = hash_action;
+    entry_action.param = param;
+    arrs[0] = hash_table->arr;
+    sizes[0] = hash_table->table_size;
+    arrs[1] = hash_table->old_arr;
+    sizes[1] = hash_table->old_size;
+
+    for(; ((arr_idx < 2) && (0 == res)); ++arr_idx)
+    {
+        size_t idx = 0;
+
+        for(; ((idx < sizes[arr_idx]) && (0 == res)); ++idx)
         {
-            return 0;
+            dlist_t *list = arrs[arr_idx][idx];
+
+            if(NULL != list)
+            {
+                res = DListForEach(DListBegin(list), DListEnd(list),
+                                   EntryAction, &entry_action);
+            }
         }
     }
-    return 1;
+    return res;
+
 }
 
 /*----------------------------------------------------------------------------*/
 
-int HashTableForEach(const hash_table_t *hash_table, hash_action_t hash_action, void *param)
+void HashTableSetMaxLoad(hash_table_t *hash_table, double max_load)
+{
+    assert(NULL != hash_table);
+    assert(0 < max_load);
+
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        RHTableSetMaxLoad(hash_table->rh_table, max_load);
+        return;
+    }
+
+    hash_table->max_load = max_load;
+}
+
+/*----------------------------------------------------------------------------*/
+
+void HashTableStats(const hash_table_t *hash_table, hash_stats_t *stats)
 {
     size_t idx = 0;
-    int res = 0;
 
     assert(NULL != hash_table);
-    assert(NULL != hash_action);
+    assert(NULL != stats);
 
-    for(; ((idx < hash_table->table_size) && (0 == res)); ++idx)
+    for(idx = 0; idx < HASH_STATS_BINS; ++idx)
     {
-        dlist_t *list = hash_table->arr[idx];
-        res = DListForEach(DListBegin(list), DListEnd(list),hash_action, param);
+        stats->hist[idx] = 0;
     }
-    return res;
+    stats->size = HashTableSize(hash_table);
+    stats->max_len = 0;
+
+    /* a slot holds one entry, the spread shows in the probe lengths */
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        stats->buckets = RHTableCapacity(hash_table->rh_table);
+        stats->used_buckets = stats->size;
+        stats->max_len = RHTableProbeHist(hash_table->rh_table, stats->hist,
+                                          HASH_STATS_BINS);
+        return;
+    }
+
+    stats->buckets = hash_table->table_size + hash_table->old_size;
+    stats->used_buckets = hash_table->used_buckets;
+
+    for(idx = 0; idx < stats->buckets; ++idx)
+    {
+        dlist_t *list = (idx < hash_table->table_size) ?
+                        hash_table->arr[idx] :
+                        hash_table->old_arr[idx - hash_table->table_size];
+        size_t chain = (NULL == list) ? 0 : DListSize(list);
 
+        stats->hist[(chain < HASH_STATS_BINS) ? chain : HASH_STATS_BINS - 1] += 1;
+        if(chain > stats->max_len)
+        {
+            stats->max_len = chain;
+        }
+    }
 }
 
+/*----------------------------------------------------------------------------*/
+
 double HashTableLoad(const hash_table_t *hash_table)
 {
     assert(NULL != hash_table);
 
-    return ((HashTableSize(hash_table)) / (hash_table->table_size));
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        return ((double)RHTableSize(hash_table->rh_table) /
+                RHTableCapacity(hash_table->rh_table));
+    }
+
+    return ((double)(HashTableSize(hash_table)) / (hash_table->table_size));
 }
 
 double HashTableSD(const hash_table_t *hash_table)
@@ -228,14 +701,25 @@ double HashTableSD(const hash_table_t *hash_table)
 
     assert(NULL != hash_table);
 
-    for(; idx < hash_table->table_size ;++idx)
+    /* there are no chains, the spread shows in the probe lengths */
+    if(HASH_OPEN_ADDRESSING == hash_table->backend)
+    {
+        return RHTableProbeSD(hash_table->rh_table);
+    }
+
+    /* while growing, the chains not moved yet are counted as they are */
+    for(; idx < hash_table->table_size + hash_table->old_size ;++idx)
     {
 
-        dlist_t *list = hash_table->arr[idx];
-        res += pow(DListSize(list) - load_factor, 2);
+        dlist_t *list = (idx < hash_table->table_size) ?
+                        hash_table->arr[idx] :
+                        hash_table->old_arr[idx - hash_table->table_size];
+        size_t chain = (NULL == list) ? 0 : DListSize(list);
+
+        res += pow(chain - load_factor, 2);
     }
 
-    res = sqrt(res / (hash_table->table_size));
+    res = sqrt(res / (hash_table->table_size + hash_table->old_size));
 
     return res;
 }
@@ -0,0 +1,335 @@
+/********************************************
+File name : heap.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <assert.h>	/* assert */
+#include <stdlib.h>	/* malloc, realloc, free */
+
+#include "heap.h" /* heap API */
+
+#define HEAP_INITIAL_CAPACITY (16)
+#define PARENT(idx) (((idx) - 1) / 2)
+#define LEFT_CHILD(idx) (2 * (idx) + 1)
+
+typedef struct heap_entry
+{
+	void *data;
+	size_t seq;
+} heap_entry_t;
+
+struct heap
+{
+	heap_entry_t *arr;
+	size_t size;
+	size_t capacity;
+	size_t next_seq;
+	heap_cmp_t cmp;
+	heap_set_index_t set_index;
+};
+
+static int IsHigher(const heap_t *heap, size_t idx1, size_t idx2);
+static void Swap(heap_t *heap, size_t idx1, size_t idx2);
+static void UpdateIndex(heap_t *heap, size_t idx);
+static void SiftUp(heap_t *heap, size_t idx);
+static void SiftDown(heap_t *heap, size_t idx);
+static void *RemoveAt(heap_t *heap, size_t idx);
+static int Reserve(heap_t *heap, size_t capacity);
+
+/*----------------------------------------------------------------------------*/
+
+heap_t *HeapCreate(heap_cmp_t cmp)
+{
+	return HeapCreateIndexed(cmp, NULL);
+}
+
+heap_t *HeapCreateIndexed(heap_cmp_t cmp, heap_set_index_t set_index)
+{
+	heap_t *heap = NULL;
+
+	assert(NULL != cmp);
+
+	heap = (heap_t *)malloc(sizeof(heap_t));
+	if(NULL == heap)
+	{
+		return NULL;
+	}
+
+	heap->arr = (heap_entry_t *)malloc(sizeof(heap_entry_t) *
+	                                   HEAP_INITIAL_CAPACITY);
+	if(NULL == heap->arr)
+	{
+		free(heap);
+		return NULL;
+	}
+
+	heap->size = 0;
+	heap->capacity = HEAP_INITIAL_CAPACITY;
+	heap->next_seq = 0;
+	heap->cmp = cmp;
+	heap->set_index = set_index;
+
+	return heap;
+}
+
+void HeapDestroy(heap_t *heap)
+{
+	assert(NULL != heap);
+
+	free(heap->arr); heap->arr = NULL;
+	free(heap); heap = NULL;
+}
+
+int HeapPush(heap_t *heap, const void *data)
+{
+	assert(NULL != heap);
+	assert(NULL != data);
+
+	if(heap->size == heap->capacity && 0 != Reserve(heap, heap->capacity * 2))
+	{
+		return 1;
+	}
+
+	heap->arr[heap->size].data = (void *)data;
+	heap->arr[heap->size].seq = heap->next_seq++;
+	++heap->size;
+
+	UpdateIndex(heap, heap->size - 1);
+	SiftUp(heap, heap->size - 1);
+
+	return 0;
+}
+
+int HeapPushMany(heap_t *heap, void *const *data, size_t n)
+{
+	size_t old_size = 0;
+	size_t idx = 0;
+
+	assert(NULL != heap);
+	assert(NULL != data || 0 == n);
+
+	old_size = heap->size;
+	if(old_size + n > heap->capacity)
+	{
+		size_t capacity = heap->capacity * 2;
+
+		if(0 != Reserve(heap, (old_size + n > capacity) ? old_size + n :
+		                                                   capacity))
+		{
+			return 1;
+		}
+	}
+
+	for(idx = 0; idx < n; ++idx)
+	{
+		assert(NULL != data[idx]);
+
+		heap->arr[heap->size].data = data[idx];
+		heap->arr[heap->size].seq = heap->next_seq++;
+		UpdateIndex(heap, heap->size);
+		++heap->size;
+	}
+
+	/* a large batch is cheaper to heapify bottom up in O(size) than to sift
+	   up one by one in O(n log size) */
+	if(n >= old_size)
+	{
+		for(idx = heap->size / 2; 0 < idx; --idx)
+		{
+			SiftDown(heap, idx - 1);
+		}
+	}
+	else
+	{
+		for(idx = old_size; idx < heap->size; ++idx)
+		{
+			SiftUp(heap, idx);
+		}
+	}
+
+	return 0;
+}
+
+void *HeapPop(heap_t *heap)
+{
+	assert(NULL != heap);
+	assert(0 < heap->size);
+
+	return RemoveAt(heap, 0);
+}
+
+void *HeapPeek(const heap_t *heap)
+{
+	assert(NULL != heap);
+
+	return (0 == heap->size) ? NULL : heap->arr[0].data;
+}
+
+void *HeapRemove(heap_t *heap, heap_is_match_t is_match, const void *param)
+{
+	size_t idx = 0;
+
+	assert(NULL != heap);
+	assert(NULL != is_match);
+
+	for(; idx < heap->size; ++idx)
+	{
+		if(is_match(heap->arr[idx].data, param))
+		{
+			return RemoveAt(heap, idx);
+		}
+	}
+
+	return NULL;
+}
+
+void *HeapRemoveAt(heap_t *heap, size_t index)
+{
+	assert(NULL != heap);
+	assert(index < heap->size);
+
+	return RemoveAt(heap, index);
+}
+
+void HeapUpdateAt(heap_t *heap, size_t index)
+{
+	assert(NULL != heap);
+	assert(index < heap->size);
+
+	heap->arr[index].seq = heap->next_seq++;
+	SiftDown(heap, index);
+	SiftUp(heap, index);
+}
+
+size_t HeapSize(const heap_t *heap)
+{
+	assert(NULL != heap);
+
+	return heap->size;
+}
+
+int HeapIsEmpty(const heap_t *heap)
+{
+	assert(NULL != heap);
+
+	return (0 == heap->size);
+}
+
+void HeapClear(heap_t *heap)
+{
+	assert(NULL != heap);
+
+	if(NULL != heap->set_index)
+	{
+		size_t idx = 0;
+
+		for(; idx < heap->size; ++idx)
+		{
+			heap->set_index(heap->arr[idx].data, HEAP_NO_INDEX);
+		}
+	}
+
+	heap->size = 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/* equal priorities are ordered by insertion sequence to keep the FIFO
+   behaviour of the sorted list based pq */
+static int IsHigher(const heap_t *heap, size_t idx1, size_t idx2)
+{
+	int res = heap->cmp(heap->arr[idx1].data, heap->arr[idx2].data);
+
+	return (0 < res) || (0 == res && heap->arr[idx1].seq < heap->arr[idx2].seq);
+}
+
+static void Swap(heap_t *heap, size_t idx1, size_t idx2)
+{
+	heap_entry_t temp = heap->arr[idx1];
+
+	heap->arr[idx1] = heap->arr[idx2];
+	heap->arr[idx2] = temp;
+
+	UpdateIndex(heap, idx1);
+	UpdateIndex(heap, idx2);
+}
+
+static void UpdateIndex(heap_t *heap, size_t idx)
+{
+	if(NULL != heap->set_index)
+	{
+		heap->set_index(heap->arr[idx].data, idx);
+	}
+}
+
+static void SiftUp(heap_t *heap, size_t idx)
+{
+	while(0 < idx && IsHigher(heap, idx, PARENT(idx)))
+	{
+		Swap(heap, idx, PARENT(idx));
+		idx = PARENT(idx);
+	}
+}
+
+static void SiftDown(heap_t *heap, size_t idx)
+{
+	size_t child = LEFT_CHILD(idx);
+
+	while(child < heap->size)
+	{
+		if(child + 1 < heap->size && IsHigher(heap, child + 1, child))
+		{
+			++child;
+		}
+
+		if(!IsHigher(heap, child, idx))
+		{
+			break;
+		}
+
+		Swap(heap, idx, child);
+		idx = child;
+		child = LEFT_CHILD(idx);
+	}
+}
+
+static void *RemoveAt(heap_t *heap, size_t idx)
+{
+	void *data = heap->arr[idx].data;
+
+	if(NULL != heap->set_index)
+	{
+		heap->set_index(data, HEAP_NO_INDEX);
+	}
+
+	--heap->size;
+	if(idx != heap->size)
+	{
+		heap->arr[idx] = heap->arr[heap->size];
+		UpdateIndex(heap, idx);
+		SiftDown(heap, idx);
+		SiftUp(heap, idx);
+	}
+
+	return data;
+}
+
+static int Reserve(heap_t *heap, size_t capacity)
+{
+	heap_entry_t *new_arr = (heap_entry_t *)realloc(heap->arr,
+	                                       sizeof(heap_entry_t) * capacity);
+	if(NULL == new_arr)
+	{
+		return 1;
+	}
+
+	heap->arr = new_arr;
+	heap->capacity = capacity;
+
+	return 0;
+}
@@ -10,31 +10,87 @@
 #include <stdlib.h> /* malloc(), free() */
 #include "pq.h" /* pq functions declaration */
 #include "sorted_list.h" /* sl functions declaration */
+#include "heap.h" /* heap functions declaration */
 
 /**********************************pq************************************/
 
+static int IsSameData(const void *data, const void *params);
+
 struct pq
 {
+	pq_backend_t backend;
 	sorted_list_t *sorted_list;
+	heap_t *heap;
 };
 
 /*******************************************************************************
                             PQCreate                             
 *******************************************************************************/
 pq_t *PQCreate(int (*cmp)( const void *new_data, const void *existing_data))
+{
+	return PQCreateBackend(cmp, PQ_DEFAULT_BACKEND);
+}
+
+/*******************************************************************************
+                            PQCreateBackend                             
+*******************************************************************************/
+pq_t *PQCreateBackend(int (*cmp)(const void *new_data, const void *existing_data),
+                      pq_backend_t backend)
+{
+	pq_t *pq = (pq_t *) malloc (sizeof(pq_t));
+	
+	assert(NULL != cmp);
+	
+	if(NULL == pq)
+	{
+		return NULL;
+	}
+	
+	pq->backend = backend;
+	pq->sorted_list = NULL;
+	pq->heap = NULL;
+	
+	if(PQ_HEAP == backend)
+	{
+		pq->heap = HeapCreate(cmp);
+	}
+	else
+	{
+		/* the queue never merges, so its nodes can come from a pool of its
+		   own and enqueue / dequeue churn stays off malloc */
+		pq->sorted_list = SortedListCreatePooled(cmp, NULL);
+	}
+	
+	if(NULL == pq->sorted_list && NULL == pq->heap)
+	{
+		free(pq);
+		return NULL;
+	}
+
+	return pq;
+}
+
+/*******************************************************************************
+                            PQCreateAddressable                             
+*******************************************************************************/
+pq_t *PQCreateAddressable(int (*cmp)(const void *new_data, const void *existing_data),
+                          pq_set_index_t set_index)
 {
 	pq_t *pq = (pq_t *) malloc (sizeof(pq_t));
 	
 	assert(NULL != cmp);
+	assert(NULL != set_index);
 	
 	if(NULL == pq)
 	{
 		return NULL;
 	}
 	
-	pq->sorted_list = SortedListCreate(cmp);
+	pq->backend = PQ_HEAP;
+	pq->sorted_list = NULL;
+	pq->heap = HeapCreateIndexed(cmp, set_index);
 	
-	if(NULL == pq->sorted_list)
+	if(NULL == pq->heap)
 	{
 		free(pq);
 		return NULL;
@@ -49,7 +105,15 @@ pq_t *PQCreate(int (*cmp)( const void *new_data, const void *existing_data))
 void PQDestroy(pq_t *pq)
 {
 	assert(NULL != pq);
-	SortedListDestroy(pq->sorted_list);
+	
+	if(PQ_HEAP == pq->backend)
+	{
+		HeapDestroy(pq->heap);
+	}
+	else
+	{
+		SortedListDestroy(pq->sorted_list);
+	}
 	free(pq); pq = NULL;
 	
 }
@@ -64,12 +128,50 @@ int PQEnqueue(pq_t *pq, const void *data)
 	assert(NULL != pq);
 	assert(NULL != data);
 	
+	if(PQ_HEAP == pq->backend)
+	{
+		return HeapPush(pq->heap, data);
+	}
+	
 	iter = SortedListInsert(pq->sorted_list, data);
 	return SortedListIsSameIter(iter, SortedListEnd(pq->sorted_list));	
 		
 }
 
 
+/*******************************************************************************
+                             PQEnqueueMany                            
+*******************************************************************************/
+int PQEnqueueMany(pq_t *pq, void *const *data, size_t n)
+{
+	size_t idx = 0;
+	
+	assert(NULL != pq);
+	assert(NULL != data || 0 == n);
+	
+	if(PQ_HEAP == pq->backend)
+	{
+		return HeapPushMany(pq->heap, data, n);
+	}
+	
+	for(; idx < n; ++idx)
+	{
+		if(0 != PQEnqueue(pq, data[idx]))
+		{
+			/* keep all or nothing, take back what was added */
+			while(0 < idx)
+			{
+				--idx;
+				PQErase(pq, IsSameData, data[idx]);
+			}
+			
+			return 1;
+		}
+	}
+	
+	return 0;
+}
+
 /*******************************************************************************
                              PQDequeue                               
 *******************************************************************************/
@@ -79,6 +181,11 @@ void *PQDequeue(pq_t *pq)
 	
 	assert(NULL != pq);
 	
+	if(PQ_HEAP == pq->backend)
+	{
+		return HeapPop(pq->heap);
+	}
+	
 	last_element = PQPeek(pq);
 	SortedListRemove(pq->sorted_list, SortedListPrevIter(SortedListEnd(pq->sorted_list)));
 	
@@ -94,6 +201,11 @@ size_t PQSize(const pq_t *pq)
 {
 	assert(NULL != pq);
 	
+	if(PQ_HEAP == pq->backend)
+	{
+		return HeapSize(pq->heap);
+	}
+	
 	return SortedListSize(pq->sorted_list);
 	
 }
@@ -107,6 +219,11 @@ void *PQPeek(const pq_t *pq)
 {
 	assert(NULL != pq);
 	
+	if(PQ_HEAP == pq->backend)
+	{
+		return HeapPeek(pq->heap);
+	}
+	
 	return SortedListGetData(SortedListPrevIter(SortedListEnd(pq->sorted_list)));
 	
 }
@@ -118,6 +235,11 @@ int PQIsEmpty(const pq_t *pq)
 {
 	assert(NULL != pq);
 	
+	if(PQ_HEAP == pq->backend)
+	{
+		return HeapIsEmpty(pq->heap);
+	}
+	
 	return 	SortedListIsEmpty(pq->sorted_list);
 
 }
@@ -134,6 +256,11 @@ void *PQErase(pq_t *pq, int (*is_match)(const void *data, const void *params), v
 	assert(NULL != is_match);
 	assert(NULL != params);
 	
+	if(PQ_HEAP == pq->backend)
+	{
+		return HeapRemove(pq->heap, is_match, params);
+	}
+	
 	iter = SortedListFindIf(pq->sorted_list, is_match, params);
 	if(0 == SortedListIsSameIter(iter, SortedListEnd(pq->sorted_list)))	
 	{
@@ -144,6 +271,28 @@ void *PQErase(pq_t *pq, int (*is_match)(const void *data, const void *params), v
 	return data;
 }
 
+/*******************************************************************************
+                             PQEraseAt                            
+*******************************************************************************/
+void *PQEraseAt(pq_t *pq, size_t index)
+{
+	assert(NULL != pq);
+	assert(PQ_HEAP == pq->backend);
+	
+	return HeapRemoveAt(pq->heap, index);
+}
+
+/*******************************************************************************
+                             PQUpdateAt                            
+*******************************************************************************/
+void PQUpdateAt(pq_t *pq, size_t index)
+{
+	assert(NULL != pq);
+	assert(PQ_HEAP == pq->backend);
+	
+	HeapUpdateAt(pq->heap, index);
+}
+
 /*******************************************************************************
                             PQClear                        
 *******************************************************************************/
@@ -153,6 +302,12 @@ void PQClear(pq_t *pq)
 	
 	assert(NULL != pq);
 	
+	if(PQ_HEAP == pq->backend)
+	{
+		HeapClear(pq->heap);
+		return;
+	}
+	
 	iter = SortedListBegin(pq->sorted_list);
 	while(0 == SortedListIsSameIter(iter,SortedListEnd(pq->sorted_list)))
 	{
@@ -161,3 +316,7 @@ void PQClear(pq_t *pq)
 	
 }
 
+static int IsSameData(const void *data, const void *params)
+{
+	return (data == params);
+}
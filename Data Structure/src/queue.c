@@ -2,19 +2,26 @@
 File name : queue.c
 Author : Omer Avioz
 Reviewer : Mor Espresco
-Infinity Labs OL95	
+Infinity Labs OL95
 *******************************************/
 
 /* 				External Libraries
 -------------------------------------------*/
 #include <assert.h> /*assert */
-#include <stdlib.h>	/*malloc, free */
-#include "singly_linked_list.h"
+#include <stdlib.h>	/*malloc, realloc, free */
+#include <string.h>	/*memcpy */
 #include "queue.h"
 
+#define QUEUE_MIN_CAPACITY (8)
+
+/* a ring buffer of data pointers. The capacity is a power of two, so the
+   position of the i-th element is (head + i) & (capacity - 1) */
 struct queue
 {
-	slist_t *slist;
+	void **buffer;
+	size_t capacity;
+	size_t head;
+	size_t size;
 };
 
 queue_t *QueueCreate(void);
@@ -24,7 +31,10 @@ void QueueDequeue(queue_t *queue);
 size_t QueueSize(const queue_t *queue);
 void *QueuePeek(const queue_t *queue);
 int QueueIsEmpty(const queue_t *queue);
-void QueueAppend(queue_t *src, queue_t *dest);
+int QueueAppend(queue_t *src, queue_t *dest);
+
+static int Reserve(queue_t *queue, size_t needed);
+static void RingWrite(queue_t *queue, size_t pos, void *const *data, size_t n);
 
 
 
@@ -37,13 +47,17 @@ queue_t *QueueCreate(void)
 		return NULL;
 	}
 	
-	new_queue->slist = SListCreate();
+	new_queue->buffer = (void **)malloc(QUEUE_MIN_CAPACITY * sizeof(void *));
 	
-	if(NULL == new_queue->slist)
+	if(NULL == new_queue->buffer)
 	{
 		free(new_queue);
 		return NULL;
 	}
+	
+	new_queue->capacity = QUEUE_MIN_CAPACITY;
+	new_queue->head = 0;
+	new_queue->size = 0;
 	return new_queue;
 }
 
@@ -51,7 +65,7 @@ void QueueDestroy(queue_t *queue)
 {
 	assert(NULL != queue);
 	
-	SListDestroy(queue->slist);
+	free(queue->buffer);
 	free(queue); queue = NULL;
 	
 }
@@ -61,43 +75,132 @@ int QueueEnqueue(queue_t *queue, const void *data)
 	assert(NULL != queue);
 	assert(NULL != data);
 	
-	return SListPushBack((queue->slist),data);
+	if(0 != Reserve(queue, queue->size + 1))
+	{
+		return 1;
+	}
+	
+	queue->buffer[(queue->head + queue->size) & (queue->capacity - 1)] =
+	                                                            (void *)data;
+	++queue->size;
+	
+	return 0;
 	
 }
 
 void QueueDequeue(queue_t *queue)
 {
 	assert(NULL != queue);
+	assert(!QueueIsEmpty(queue));
 	
-	SListRemove(queue->slist, SListBegin(queue->slist));
+	queue->head = (queue->head + 1) & (queue->capacity - 1);
+	--queue->size;
 }
 
 size_t QueueSize(const queue_t *queue)
 {
 	assert(NULL != queue);
 	
-	return SListSize(queue->slist);
+	return queue->size;
 }
 
 void *QueuePeek(const queue_t *queue)
 {
 	assert(NULL != queue);
 	
-	return (void *)SListGetData(SListBegin(queue->slist));
+	if(QueueIsEmpty(queue))
+	{
+		return NULL;
+	}
+	
+	return queue->buffer[queue->head];
 }
 
 int QueueIsEmpty(const queue_t *queue)
 {
 	assert(NULL != queue);
 	
-	return SListIsEmpty(queue->slist);
+	return (0 == queue->size);
 }
 
-void QueueAppend(queue_t *src, queue_t *dest)
+int QueueAppend(queue_t *src, queue_t *dest)
 {
+	size_t first = 0;
+	
 	assert(NULL != src);
 	assert(NULL != dest);
+	assert(src != dest);
+	
+	if(0 != Reserve(dest, dest->size + src->size))
+	{
+		return 1;
+	}
+	
+	/* src is at most two runs: head to the end of the buffer, then from
+	   the start */
+	first = src->capacity - src->head;
+	first = (first < src->size) ? first : src->size;
+	
+	RingWrite(dest, dest->size, src->buffer + src->head, first);
+	RingWrite(dest, dest->size + first, src->buffer, src->size - first);
+	
+	dest->size += src->size;
+	src->head = 0;
+	src->size = 0;
+	
+	return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/* doubles the buffer until needed fits. realloc keeps the elements at the
+   same positions, the ones that wrapped past the old end are moved after
+   it so the elements are in order from head again */
+static int Reserve(queue_t *queue, size_t needed)
+{
+	size_t old_capacity = queue->capacity;
+	size_t new_capacity = old_capacity;
+	size_t wrapped = 0;
+	void **new_buffer = NULL;
+	
+	if(needed <= old_capacity)
+	{
+		return 0;
+	}
+	
+	while(new_capacity < needed)
+	{
+		new_capacity *= 2;
+	}
+	
+	new_buffer = (void **)realloc(queue->buffer,
+	                              new_capacity * sizeof(void *));
+	if(NULL == new_buffer)
+	{
+		return 1;
+	}
+	
+	queue->buffer = new_buffer;
+	queue->capacity = new_capacity;
+	
+	if(queue->head + queue->size > old_capacity)
+	{
+		wrapped = queue->head + queue->size - old_capacity;
+		RingWrite(queue, old_capacity - queue->head, new_buffer, wrapped);
+	}
 	
-	SListAppend(src->slist, dest->slist);
+	return 0;
 }
 
+/* copies n pointers to the positions pos.. (counted from head), at most two
+   memcpy calls when the run wraps past the end of the buffer */
+static void RingWrite(queue_t *queue, size_t pos, void *const *data, size_t n)
+{
+	size_t start = (queue->head + pos) & (queue->capacity - 1);
+	size_t first = queue->capacity - start;
+	
+	first = (first < n) ? first : n;
+	
+	memcpy(queue->buffer + start, data, first * sizeof(void *));
+	memcpy(queue->buffer, data + first, (n - first) * sizeof(void *));
+}
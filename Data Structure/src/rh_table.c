@@ -0,0 +1,626 @@
+/********************************************
+File name : rh_table.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <assert.h>	/* assert */
+#include <stdlib.h>	/* malloc, calloc, free */
+#include <limits.h>	/* CHAR_BIT */
+#include <math.h>	/* sqrt */
+
+#include "rh_table.h" /* rh table API */
+
+#define RH_MIN_CAPACITY (8)
+#define RH_MAX_DIST (255)
+#define RH_SIZE_BITS (sizeof(size_t) * CHAR_BIT)
+/* 2^64 / golden ratio - spreads the user hash over the high bits */
+#define RH_FIB_MULT ((size_t)0x9E3779B97F4A7C15UL)
+#define RH_DEFAULT_MAX_LOAD (0.875)
+#define RH_MAX_MAX_LOAD (0.95)
+/* min slots of the old array handled by one insert / remove while growing */
+#define RH_REHASH_STEP (8)
+/* keys of RHTableFindBatch handled together */
+#define RH_BATCH (16)
+
+#ifdef __GNUC__
+#define PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define PREFETCH(addr) ((void)(addr))
+#endif
+
+/* RH_FIB_MULT needs a 64 bit size_t, the build fails here on a
+   narrower one */
+typedef char size_t_is_64_bits[(8 == sizeof(size_t)) ? 1 : -1];
+
+typedef struct rh_array
+{
+	void **slots;
+	size_t *hashes;
+	unsigned char *dist;
+	size_t capacity;
+	size_t size;
+	size_t shift;
+} rh_array_t;
+
+/* while growing, entries are moved from old to arr a few at a time. Every
+   slot of old below cursor is empty, a removal in old only shifts entries
+   back down to the removed slot so it never moves one below cursor. */
+struct rh_table
+{
+	rh_array_t arr;
+	rh_array_t old;
+	size_t cursor;
+	size_t grow_at;
+	double max_load;
+	rh_hash_t hash;
+	rh_is_match_t is_match;
+};
+
+static int InitArray(rh_array_t *arr, size_t capacity);
+static void SetGrowAt(rh_table_t *table);
+static size_t Home(const rh_array_t *arr, size_t hash);
+static size_t Next(const rh_array_t *arr, size_t idx);
+static size_t Lookup(const rh_table_t *table, const rh_array_t *arr,
+                     const void *key, size_t hash);
+static int Place(rh_array_t *arr, void *data, size_t hash);
+static void *RemoveAt(rh_array_t *arr, size_t idx);
+static int IsGrowing(const rh_table_t *table);
+static void MigrateStep(rh_table_t *table, size_t steps);
+static size_t RehashSteps(const rh_table_t *table);
+static int Grow(rh_table_t *table);
+
+/*----------------------------------------------------------------------------*/
+
+rh_table_t *RHTableCreate(size_t capacity, rh_hash_t hash,
+                          rh_is_match_t is_match)
+{
+	rh_table_t *table = NULL;
+
+	assert(NULL != hash);
+	assert(NULL != is_match);
+
+	table = (rh_table_t *)malloc(sizeof(rh_table_t));
+	if(NULL == table)
+	{
+		return NULL;
+	}
+
+	if(0 != InitArray(&table->arr, capacity))
+	{
+		free(table);
+		return NULL;
+	}
+
+	table->old.slots = NULL;
+	table->old.hashes = NULL;
+	table->old.dist = NULL;
+	table->old.capacity = 0;
+	table->old.size = 0;
+	table->cursor = 0;
+	table->max_load = RH_DEFAULT_MAX_LOAD;
+	table->hash = hash;
+	table->is_match = is_match;
+	SetGrowAt(table);
+
+	return table;
+}
+
+void RHTableDestroy(rh_table_t *table)
+{
+	assert(NULL != table);
+
+	free(table->old.slots); table->old.slots = NULL;
+	free(table->arr.slots); table->arr.slots = NULL;
+	free(table); table = NULL;
+}
+
+int RHTableInsert(rh_table_t *table, void *data)
+{
+	assert(NULL != table);
+
+	return RHTableInsertHashed(table, data, table->hash(data));
+}
+
+int RHTableInsertHashed(rh_table_t *table, void *data, size_t hash)
+{
+	assert(NULL != table);
+	assert(NULL != data);
+
+	MigrateStep(table, RehashSteps(table));
+
+	/* without memory to grow, the table can still fill up to one free slot.
+	   A growth is still in progress here only if an entry of old could not
+	   be placed */
+	if(table->arr.size + 1 > table->grow_at &&
+	   (IsGrowing(table) || 0 != Grow(table)) &&
+	   table->arr.size + 1 >= table->arr.capacity)
+	{
+		return 1;
+	}
+
+	/* a long probe on a lightly loaded table means colliding hashes,
+	   growing would not help. This rare case finishes the growth in
+	   progress at once */
+	while(0 != Place(&table->arr, data, hash))
+	{
+		MigrateStep(table, (size_t)-1);
+		if(table->arr.size < table->arr.capacity / 4 || IsGrowing(table) ||
+		   0 != Grow(table))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+void *RHTableRemove(rh_table_t *table, const void *key)
+{
+	assert(NULL != table);
+
+	return RHTableRemoveHashed(table, key, table->hash(key));
+}
+
+void *RHTableRemoveHashed(rh_table_t *table, const void *key, size_t hash)
+{
+	size_t idx = 0;
+
+	assert(NULL != table);
+
+	MigrateStep(table, RehashSteps(table));
+
+	idx = Lookup(table, &table->arr, key, hash);
+	if(table->arr.capacity != idx)
+	{
+		return RemoveAt(&table->arr, idx);
+	}
+
+	if(IsGrowing(table))
+	{
+		idx = Lookup(table, &table->old, key, hash);
+		if(table->old.capacity != idx)
+		{
+			return RemoveAt(&table->old, idx);
+		}
+	}
+
+	return NULL;
+}
+
+void *RHTableFind(const rh_table_t *table, const void *key)
+{
+	assert(NULL != table);
+
+	return RHTableFindHashed(table, key, table->hash(key));
+}
+
+void *RHTableFindHashed(const rh_table_t *table, const void *key, size_t hash)
+{
+	size_t idx = 0;
+
+	assert(NULL != table);
+
+	idx = Lookup(table, &table->arr, key, hash);
+	if(table->arr.capacity != idx)
+	{
+		return table->arr.slots[idx];
+	}
+
+	if(IsGrowing(table))
+	{
+		idx = Lookup(table, &table->old, key, hash);
+		if(table->old.capacity != idx)
+		{
+			return table->old.slots[idx];
+		}
+	}
+
+	return NULL;
+}
+
+void RHTableFindBatch(const rh_table_t *table, const void *const *keys,
+                      void **out, size_t n)
+{
+	size_t hashes[RH_BATCH] = {0};
+	size_t first = 0;
+
+	assert(NULL != table);
+	assert(NULL != keys || 0 == n);
+	assert(NULL != out || 0 == n);
+
+	for(; first < n; first += RH_BATCH)
+	{
+		size_t count = (n - first < RH_BATCH) ? n - first : RH_BATCH;
+		size_t idx = 0;
+
+		for(idx = 0; idx < count; ++idx)
+		{
+			size_t home = 0;
+
+			hashes[idx] = table->hash(keys[first + idx]);
+			home = Home(&table->arr, hashes[idx]);
+			PREFETCH(table->arr.dist + home);
+			PREFETCH(table->arr.hashes + home);
+			PREFETCH(table->arr.slots + home);
+		}
+
+		/* is_match reads the entry itself, usually the one at home */
+		for(idx = 0; idx < count; ++idx)
+		{
+			size_t home = Home(&table->arr, hashes[idx]);
+
+			if(hashes[idx] == table->arr.hashes[home])
+			{
+				PREFETCH(table->arr.slots[home]);
+			}
+		}
+
+		for(idx = 0; idx < count; ++idx)
+		{
+			const void *key = keys[first + idx];
+			size_t slot = Lookup(table, &table->arr, key, hashes[idx]);
+
+			out[first + idx] = NULL;
+			if(table->arr.capacity != slot)
+			{
+				out[first + idx] = table->arr.slots[slot];
+			}
+			else if(IsGrowing(table))
+			{
+				slot = Lookup(table, &table->old, key, hashes[idx]);
+				if(table->old.capacity != slot)
+				{
+					out[first + idx] = table->old.slots[slot];
+				}
+			}
+		}
+	}
+}
+
+int RHTableForEach(const rh_table_t *table, rh_action_t action, void *param)
+{
+	const rh_array_t *arrs[2];
+	size_t n_arrs = 1;
+	size_t arr_idx = 0;
+	int res = 0;
+
+	assert(NULL != table);
+	assert(NULL != action);
+
+	arrs[0] = &table->arr;
+	arrs[1] = &table->old;
+	n_arrs += IsGrowing(table);
+
+	for(; arr_idx < n_arrs && 0 == res; ++arr_idx)
+	{
+		const rh_array_t *arr = arrs[arr_idx];
+		size_t idx = 0;
+
+		for(; idx < arr->capacity && 0 == res; ++idx)
+		{
+			if(0 != arr->dist[idx])
+			{
+				res = action(arr->slots[idx], param);
+			}
+		}
+	}
+
+	return res;
+}
+
+size_t RHTableSize(const rh_table_t *table)
+{
+	assert(NULL != table);
+
+	return table->arr.size + table->old.size;
+}
+
+size_t RHTableCapacity(const rh_table_t *table)
+{
+	assert(NULL != table);
+
+	return table->arr.capacity;
+}
+
+void RHTableSetMaxLoad(rh_table_t *table, double max_load)
+{
+	assert(NULL != table);
+	assert(0 < max_load);
+
+	table->max_load = (RH_MAX_MAX_LOAD < max_load) ? RH_MAX_MAX_LOAD : max_load;
+	SetGrowAt(table);
+}
+
+size_t RHTableProbeHist(const rh_table_t *table, size_t *hist, size_t n_bins)
+{
+	const rh_array_t *arrs[2];
+	size_t n_arrs = 1;
+	size_t arr_idx = 0;
+	size_t max_probe = 0;
+
+	assert(NULL != table);
+	assert(NULL != hist);
+	assert(0 < n_bins);
+
+	arrs[0] = &table->arr;
+	arrs[1] = &table->old;
+	n_arrs += IsGrowing(table);
+
+	for(; arr_idx < n_arrs; ++arr_idx)
+	{
+		const rh_array_t *arr = arrs[arr_idx];
+		size_t idx = 0;
+
+		for(; idx < arr->capacity; ++idx)
+		{
+			if(0 != arr->dist[idx])
+			{
+				size_t probe = arr->dist[idx] - 1;
+
+				hist[(probe < n_bins) ? probe : n_bins - 1] += 1;
+				max_probe = (probe > max_probe) ? probe : max_probe;
+			}
+		}
+	}
+
+	return max_probe;
+}
+
+double RHTableProbeSD(const rh_table_t *table)
+{
+	const rh_array_t *arrs[2];
+	size_t n_arrs = 1;
+	size_t arr_idx = 0;
+	double sum = 0;
+	double sum_sq = 0;
+	double mean = 0;
+	size_t size = 0;
+
+	assert(NULL != table);
+
+	size = RHTableSize(table);
+	if(0 == size)
+	{
+		return 0;
+	}
+
+	arrs[0] = &table->arr;
+	arrs[1] = &table->old;
+	n_arrs += IsGrowing(table);
+
+	for(; arr_idx < n_arrs; ++arr_idx)
+	{
+		const rh_array_t *arr = arrs[arr_idx];
+		size_t idx = 0;
+
+		for(; idx < arr->capacity; ++idx)
+		{
+			if(0 != arr->dist[idx])
+			{
+				double probe = arr->dist[idx] - 1;
+
+				sum += probe;
+				sum_sq += probe * probe;
+			}
+		}
+	}
+
+	mean = sum / size;
+	sum_sq = sum_sq / size - mean * mean;
+
+	return (0 < sum_sq) ? sqrt(sum_sq) : 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/* slots, hashes and dist share one allocation */
+static int InitArray(rh_array_t *arr, size_t capacity)
+{
+	size_t bits = 0;
+
+	while(((size_t)1 << bits) < capacity || ((size_t)1 << bits) < RH_MIN_CAPACITY)
+	{
+		++bits;
+	}
+	capacity = (size_t)1 << bits;
+
+	arr->slots = (void **)calloc(capacity, sizeof(void *) + sizeof(size_t) + 1);
+	if(NULL == arr->slots)
+	{
+		return 1;
+	}
+
+	arr->hashes = (size_t *)(arr->slots + capacity);
+	arr->dist = (unsigned char *)(arr->hashes + capacity);
+	arr->capacity = capacity;
+	arr->size = 0;
+	arr->shift = RH_SIZE_BITS - bits;
+
+	return 0;
+}
+
+static void SetGrowAt(rh_table_t *table)
+{
+	table->grow_at = (size_t)(table->max_load * table->arr.capacity);
+}
+
+static size_t Home(const rh_array_t *arr, size_t hash)
+{
+	return (hash * RH_FIB_MULT) >> arr->shift;
+}
+
+static size_t Next(const rh_array_t *arr, size_t idx)
+{
+	return (idx + 1) & (arr->capacity - 1);
+}
+
+/* returns the slot of the entry, capacity if not found. The stored hash
+   is compared first, is_match is called only when the hashes are equal. */
+static size_t Lookup(const rh_table_t *table, const rh_array_t *arr,
+                     const void *key, size_t hash)
+{
+	size_t idx = Home(arr, hash);
+	size_t dist = 1;
+
+	/* every entry from here on is closer to its home than key would be */
+	for(; dist <= arr->dist[idx]; ++dist, idx = Next(arr, idx))
+	{
+		if(hash == arr->hashes[idx] && table->is_match(arr->slots[idx], key))
+		{
+			return idx;
+		}
+	}
+
+	return arr->capacity;
+}
+
+/* the new entry goes before the first entry that is closer to its home and
+   every entry up to the next empty slot moves one slot forward, which is
+   the same as swapping along the probe like the classic Robin Hood insert.
+   Checked before anything moves, so a failure leaves the array unchanged. */
+static int Place(rh_array_t *arr, void *data, size_t hash)
+{
+	size_t idx = Home(arr, hash);
+	size_t dist = 1;
+	size_t end = 0;
+
+	for(; dist <= arr->dist[idx]; ++dist, idx = Next(arr, idx))
+	{
+	}
+
+	if(RH_MAX_DIST < dist)
+	{
+		return 1;
+	}
+
+	for(end = idx; 0 != arr->dist[end]; end = Next(arr, end))
+	{
+		if(RH_MAX_DIST == arr->dist[end])
+		{
+			return 1;
+		}
+	}
+
+	while(end != idx)
+	{
+		size_t prev = (end - 1) & (arr->capacity - 1);
+
+		arr->slots[end] = arr->slots[prev];
+		arr->hashes[end] = arr->hashes[prev];
+		arr->dist[end] = arr->dist[prev] + 1;
+		end = prev;
+	}
+
+	arr->slots[idx] = data;
+	arr->hashes[idx] = hash;
+	arr->dist[idx] = (unsigned char)dist;
+	++arr->size;
+
+	return 0;
+}
+
+/* backward shift: pull the following displaced entries one slot back, so
+   no tombstones are left */
+static void *RemoveAt(rh_array_t *arr, size_t idx)
+{
+	void *data = arr->slots[idx];
+	size_t next = Next(arr, idx);
+
+	for(; 1 < arr->dist[next]; idx = next, next = Next(arr, next))
+	{
+		arr->slots[idx] = arr->slots[next];
+		arr->hashes[idx] = arr->hashes[next];
+		arr->dist[idx] = arr->dist[next] - 1;
+	}
+	arr->slots[idx] = NULL;
+	arr->dist[idx] = 0;
+	--arr->size;
+
+	return data;
+}
+
+static int IsGrowing(const rh_table_t *table)
+{
+	return (NULL != table->old.slots);
+}
+
+/* every step moves one entry or passes one empty slot of old */
+static void MigrateStep(rh_table_t *table, size_t steps)
+{
+	rh_array_t *old = &table->old;
+
+	for(; IsGrowing(table) && 0 < steps; --steps)
+	{
+		if(0 == old->size)
+		{
+			free(old->slots);
+			old->slots = NULL;
+			old->hashes = NULL;
+			old->dist = NULL;
+			old->capacity = 0;
+		}
+		else if(0 == old->dist[table->cursor])
+		{
+			++table->cursor;
+		}
+		else if(0 == Place(&table->arr, old->slots[table->cursor],
+		                   old->hashes[table->cursor]))
+		{
+			RemoveAt(old, table->cursor);
+		}
+		else
+		{
+			return;
+		}
+	}
+}
+
+/* slots to handle by one insert / remove: the slots left spread over the
+   inserts that still fit under grow_at once the entries of old are in arr,
+   so the growth is done before arr reaches grow_at (also after a lower max
+   load is set) and no insert moves the whole table */
+static size_t RehashSteps(const rh_table_t *table)
+{
+	size_t used = table->arr.size + table->old.size;
+	size_t inserts = 0;
+	size_t left = 0;
+	size_t steps = 0;
+
+	if(!IsGrowing(table))
+	{
+		return 0;
+	}
+
+	/* + 1 for the step that frees old */
+	left = table->old.capacity - table->cursor + 1;
+	inserts = (used < table->grow_at) ? table->grow_at - used : 0;
+	steps = (0 == inserts) ? left : (left + inserts - 1) / inserts;
+
+	return (steps < RH_REHASH_STEP) ? RH_REHASH_STEP : steps;
+}
+
+/* starts moving the entries to an array twice as big. The previous growth
+   was completed by RehashSteps (or at once by the caller) before. */
+static int Grow(rh_table_t *table)
+{
+	rh_array_t old = table->arr;
+
+	assert(!IsGrowing(table));
+
+	if(0 != InitArray(&table->arr, old.capacity * 2))
+	{
+		table->arr = old;
+		return 1;
+	}
+
+	table->old = old;
+	table->cursor = 0;
+	SetGrowAt(table);
+
+	return 0;
+}
@@ -13,6 +13,9 @@ Infinity Labs OL95
 #include <assert.h> /*assert */
 #include <stdlib.h>	/*malloc, free */
 #include "singly_linked_list.h"
+#include "fsa.h" /* fsa_pool_t */
+
+#define LIST_POOL_BLOCKS (16)
 
 struct node 
 {
@@ -24,8 +27,14 @@ struct singly_linked_list
 {
 	node_t *begin;
 	node_t *end;
+	fsa_pool_t *pool;
+	int is_pool_owned;
+	size_t size;
 };
 
+static node_t *AllocNode(slist_t *list);
+static void FreeNode(slist_t *list, node_t *node);
+
 
 slist_t *SListCreate(void)
 {
@@ -39,6 +48,10 @@ slist_t *SListCreate(void)
 		return NULL;
 	} 
 	
+	new_slist->pool = NULL;
+	new_slist->is_pool_owned = 0;
+	new_slist->size = 0;
+	
 	new_node = (node_t*)malloc(sizeof(node_t));
 	
 	if(NULL == new_node)
@@ -56,6 +69,62 @@ slist_t *SListCreate(void)
 }
 
 
+slist_t *SListCreatePooled(fsa_pool_t *pool)
+{
+	slist_t *new_slist = NULL;
+	node_t *new_node = NULL;
+	
+	assert(NULL == pool || sizeof(node_t) <= FSAPoolBlockSize(pool));
+	
+	new_slist = (slist_t*)malloc(sizeof(slist_t));
+	
+	if(NULL == new_slist)
+	{
+		return NULL;
+	}
+	
+	new_slist->pool = pool;
+	new_slist->is_pool_owned = 0;
+	new_slist->size = 0;
+	
+	if(NULL == pool)
+	{
+		new_slist->pool = FSAPoolCreate(sizeof(node_t), LIST_POOL_BLOCKS);
+		if(NULL == new_slist->pool)
+		{
+			free(new_slist);
+			return NULL;
+		}
+		new_slist->is_pool_owned = 1;
+	}
+	
+	/* the dummy end node moves between nodes, it comes from the pool too */
+	new_node = AllocNode(new_slist);
+	
+	if(NULL == new_node)
+	{
+		if(new_slist->is_pool_owned)
+		{
+			FSAPoolDestroy(new_slist->pool);
+		}
+		free(new_slist);
+		return NULL;
+	}
+	
+	new_node->data = NULL;
+	new_slist->end = new_node;
+	new_slist->begin = new_slist->end;
+	
+	return new_slist;
+}
+
+
+size_t SListNodeSize(void)
+{
+	return sizeof(node_t);
+}
+
+
  
 void SListDestroy(slist_t *list)
 {
@@ -70,24 +139,28 @@ void SListDestroy(slist_t *list)
 
 	if(SListIsEmpty(list))
 	{
-		free(list->end);	
-		free(list);	
+		FreeNode(list, list->end);	
 	}
 	else
 	{	
 		while(current->next != list->end)
 		{
 			next = current->next;
-			free(current);
+			FreeNode(list, current);
 			current = next;
 		}
 		
-		free(next);
-		free(list->end);	
-		free(list);
-		
+		FreeNode(list, next);
+		FreeNode(list, list->end);	
+	}
+	
+	if(list->is_pool_owned)
+	{
+		FSAPoolDestroy(list->pool);
 	}
 	
+	free(list);
+	
 }
 
 
@@ -124,7 +197,7 @@ int SListInsertBefore(slist_t *list, slist_iter_t next_iterator, const void *dat
 	assert(NULL != next_iterator);	
 	assert(NULL != data);
 	
-	new_node = (node_t*)malloc(sizeof(node_t));
+	new_node = AllocNode(list);
 	
 	if(NULL == new_node)
 	{
@@ -140,6 +213,7 @@ int SListInsertBefore(slist_t *list, slist_iter_t next_iterator, const void *dat
 	new_node->next = next_iterator->next;
 	next_iterator->data = (void *)data;
 	next_iterator->next = new_node;
+	++list->size;
 		
 	return 0;
 }
@@ -160,7 +234,8 @@ void SListRemove(slist_t *list, slist_iter_t iterator)
 	
 	iterator->data = next_iterator->data;
 	iterator->next = next_iterator->next;
-	free(next_iterator);
+	FreeNode(list, next_iterator);
+	--list->size;
 }
 
  
@@ -206,19 +281,9 @@ int SListForEachIter(slist_iter_t first, slist_iter_t last, const action_functio
 
 size_t SListSize(const slist_t *list)
 {
-	slist_iter_t current = NULL;
-	size_t count = 0;
-	
 	assert(NULL != list);
 	
-	current = list->begin;
-	while(current != list->end)
-	{
-
-		++count;
-		current = current->next;
-	}
-	return count;
+	return list->size;
 }
 
  
@@ -284,4 +349,30 @@ void SListAppend(slist_t *src, slist_t *dest)
 	dest->end = src->end;
 	src->end = src->begin;
 	
+	dest->size += src->size;
+	src->size = 0;
+	
+}
+
+/*----------------------------------------------------------------------------*/
+
+static node_t *AllocNode(slist_t *list)
+{
+	if(NULL != list->pool)
+	{
+		return (node_t *)FSAPoolAlloc(list->pool);
+	}
+	
+	return (node_t *)malloc(sizeof(node_t));
+}
+
+static void FreeNode(slist_t *list, node_t *node)
+{
+	if(NULL != list->pool)
+	{
+		FSAPoolFree(list->pool, node);
+		return;
+	}
+	
+	free(node);
 }
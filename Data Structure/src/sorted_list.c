@@ -43,6 +43,29 @@ sorted_list_t *SortedListCreate(compare_t compare)
 	return new_list;
 }
 
+sorted_list_t *SortedListCreatePooled(compare_t compare, fsa_pool_t *pool)
+{
+	sorted_list_t *new_list = (sorted_list_t *) malloc (sizeof(sorted_list_t));
+	
+	assert(NULL != compare);
+	
+	if(NULL == new_list)
+	{
+		return NULL;
+	}
+	
+	new_list->sorted_list = DListCreatePooled(pool);
+	
+	if(NULL == new_list->sorted_list)
+	{
+		free(new_list);
+		return NULL;
+	}
+	
+	new_list->compare = compare;
+	return new_list;
+}
+
 void SortedListDestroy(sorted_list_t *list)
 {
 	assert(NULL != list);
@@ -271,7 +294,10 @@ void SortedListMerge(sorted_list_t *dest_list, sorted_list_t *src_list)
 		
 		if(SortedListIsSameIter(SortedListEnd(dest_list), dest_iter))
 		{
-			DListSplice(dest_iter.sorted_iter, src_iter.sorted_iter, 			                					   	SortedListEnd(src_list).sorted_iter);	
+			DListSpliceN(dest_list->sorted_list, dest_iter.sorted_iter,
+			             src_list->sorted_list, src_iter.sorted_iter,
+			             SortedListEnd(src_list).sorted_iter,
+			             DListSize(src_list->sorted_list));
 				
 		}
 		
@@ -279,8 +305,10 @@ void SortedListMerge(sorted_list_t *dest_list, sorted_list_t *src_list)
 								   SortedListGetData(dest_iter)) <= 0)
 		{
 			src_iter = 	SortedListNextIter(src_iter);
-		 	DListSplice(dest_iter.sorted_iter, SortedListPrevIter(src_iter).sorted_iter,
-					    src_iter.sorted_iter );
+		 	DListSpliceN(dest_list->sorted_list, dest_iter.sorted_iter,
+		 	             src_list->sorted_list,
+		 	             SortedListPrevIter(src_iter).sorted_iter,
+					     src_iter.sorted_iter, 1);
 
 		}
 		
@@ -14,21 +14,22 @@
 #include <assert.h>	/* assert*/
 #include <stdlib.h> /* malloc, free */
 
-static const int max_priority = 7;
-static int curr_priority = 0;
-
+/* uid must stay the first member, see task.h */
 struct task
 {
 	ilrd_uid_t uid;
 	int(*action)(void *params);
-	size_t frequency_in_sec;
-	time_t first_execution;
+	unsigned long interval;
+	unsigned long next_execution;
 	void *params;
+	size_t pq_index;
+	void *sched_handle;
+	task_stats_t stats;
 };
 
 
 
-task_t *TaskCreate(time_t first_execution, size_t frequency_in_sec, int(*action)(void *params), void *params)
+task_t *TaskCreate(unsigned long first_execution, unsigned long interval, int(*action)(void *params), void *params)
 {
 	task_t *new_task = (task_t *)malloc(sizeof(task_t));
 	
@@ -40,22 +41,47 @@ task_t *TaskCreate(time_t first_execution, size_t frequency_in_sec, int(*action)
 		return NULL;
 	}
 	
+	if(NULL == TaskInit(new_task, first_execution, interval, action, params))
+	{
+		free(new_task);
+		return NULL;
+	}
+	
+	return new_task;
+	
+}
+
+task_t *TaskInit(void *memory, unsigned long first_execution, unsigned long interval, int(*action)(void *params), void *params)
+{
+	task_t *new_task = (task_t *)memory;
+	
+	assert(NULL != memory);
+	assert(NULL != action);
+	
 	new_task->uid = UIDCreate();
 	if(UIDIsSame(BAD_UID,new_task->uid))
 	{
-		free(new_task);
 		return NULL;
 	}
 	
 	new_task->action = action;
 	new_task->params = params;
-	new_task->frequency_in_sec = frequency_in_sec;
-	new_task->first_execution = first_execution;
-	
-	curr_priority = (curr_priority + 1) % max_priority;
+	new_task->interval = interval;
+	new_task->next_execution = first_execution;
+	new_task->pq_index = (size_t)-1;
+	new_task->sched_handle = NULL;
+	new_task->stats.executions = 0;
+	new_task->stats.failures = 0;
+	new_task->stats.run_time_total = 0;
+	new_task->stats.run_time_max = 0;
+	new_task->stats.lateness_max = 0;
 	
 	return new_task;
-	
+}
+
+size_t TaskStructSize(void)
+{
+	return sizeof(task_t);
 }
 
 void TaskDestroy(task_t *task)
@@ -79,21 +105,83 @@ ilrd_uid_t TaskGetUID(const task_t *task)
 	return task->uid;
 }
 
-void TaskSetNextExecution(task_t *task, size_t next_execution)
+void TaskSetNextExecution(task_t *task, unsigned long now)
 {
 	assert(NULL != task);
 	
-	task->first_execution += next_execution;
+	if(0 == task->interval)
+	{
+		return;
+	}
+	
+	task->next_execution += task->interval;
+	if(task->next_execution < now)
+	{
+		task->next_execution += (now - task->next_execution + task->interval - 1)
+		                        / task->interval * task->interval;
+	}
 }
 
-size_t TaskGetFrequencyInSec(const task_t *task)
+unsigned long TaskGetInterval(const task_t *task)
 {
-	return task->frequency_in_sec;
+	return task->interval;
 }
 
-size_t TaskGetFirstExecution(const task_t *task)
+unsigned long TaskGetNextExecution(const task_t *task)
 {
-	return task->first_execution;
+	return task->next_execution;
+}
+
+void TaskSetPQIndex(void *task, size_t index)
+{
+	assert(NULL != task);
+	
+	((task_t *)task)->pq_index = index;
+}
+
+size_t TaskGetPQIndex(const task_t *task)
+{
+	assert(NULL != task);
+	
+	return task->pq_index;
+}
+
+void TaskSetSchedHandle(task_t *task, void *handle)
+{
+	assert(NULL != task);
+	
+	task->sched_handle = handle;
+}
+
+void *TaskGetSchedHandle(const task_t *task)
+{
+	assert(NULL != task);
+	
+	return task->sched_handle;
+}
+
+void TaskAddRun(task_t *task, unsigned long lateness, unsigned long run_time, int is_failed)
+{
+	assert(NULL != task);
+	
+	++task->stats.executions;
+	task->stats.failures += (0 != is_failed);
+	task->stats.run_time_total += run_time;
+	if(run_time > task->stats.run_time_max)
+	{
+		task->stats.run_time_max = run_time;
+	}
+	if(lateness > task->stats.lateness_max)
+	{
+		task->stats.lateness_max = lateness;
+	}
+}
+
+const task_stats_t *TaskGetStats(const task_t *task)
+{
+	assert(NULL != task);
+	
+	return &task->stats;
 }
 
 
@@ -0,0 +1,380 @@
+/********************************************
+File name : timing_wheel.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <assert.h>	/* assert */
+#include <stdlib.h>	/* malloc, free */
+
+#include "timing_wheel.h" /* timing wheel API */
+
+#define TW_LEVELS (5)
+#define TW_L0_BITS (8)
+#define TW_LN_BITS (6)
+#define TW_L0_SLOTS (1UL << TW_L0_BITS)
+#define TW_LN_SLOTS (1UL << TW_LN_BITS)
+#define TW_L0_MASK (TW_L0_SLOTS - 1)
+#define TW_LN_MASK (TW_LN_SLOTS - 1)
+#define TW_SLOTS_TOTAL (TW_L0_SLOTS + (TW_LEVELS - 1) * TW_LN_SLOTS)
+#define TW_MAX_DELTA (0xFFFFFFFFUL)
+
+/* first tick that is too far for a level: 2^8, 2^14, 2^20, 2^26 */
+#define LEVEL_RANGE(level) (1UL << (TW_L0_BITS + (level) * TW_LN_BITS))
+#define LEVEL_SHIFT(level) (TW_L0_BITS + ((level) - 1) * TW_LN_BITS)
+
+struct tw_timer
+{
+	tw_timer_t *next;
+	tw_timer_t *prev;
+	void *data;
+	unsigned long expire;
+	int level;
+	int is_owned;
+};
+
+struct timing_wheel
+{
+	tw_timer_t slots[TW_SLOTS_TOTAL];
+	size_t level_count[TW_LEVELS];
+	size_t size;
+	unsigned long current;
+};
+
+static tw_timer_t *GetSlot(timing_wheel_t *wheel, int level, unsigned long tick);
+static int IsSlotEmpty(const tw_timer_t *slot);
+static void Link(tw_timer_t *slot, tw_timer_t *timer);
+static void Unlink(timing_wheel_t *wheel, tw_timer_t *timer);
+static void Place(timing_wheel_t *wheel, tw_timer_t *timer);
+static void Cascade(timing_wheel_t *wheel);
+
+/*----------------------------------------------------------------------------*/
+
+timing_wheel_t *TimingWheelCreate(unsigned long now)
+{
+	timing_wheel_t *wheel = NULL;
+	size_t idx = 0;
+	int level = 0;
+
+	wheel = (timing_wheel_t *)malloc(sizeof(timing_wheel_t));
+	if(NULL == wheel)
+	{
+		return NULL;
+	}
+
+	for(; idx < TW_SLOTS_TOTAL; ++idx)
+	{
+		wheel->slots[idx].next = &wheel->slots[idx];
+		wheel->slots[idx].prev = &wheel->slots[idx];
+		wheel->slots[idx].data = NULL;
+	}
+
+	for(; level < TW_LEVELS; ++level)
+	{
+		wheel->level_count[level] = 0;
+	}
+
+	wheel->size = 0;
+	wheel->current = now;
+
+	return wheel;
+}
+
+void TimingWheelDestroy(timing_wheel_t *wheel)
+{
+	assert(NULL != wheel);
+
+	TimingWheelClear(wheel, NULL, NULL);
+	free(wheel); wheel = NULL;
+}
+
+tw_timer_t *TimingWheelAdd(timing_wheel_t *wheel, void *data,
+                           unsigned long expire)
+{
+	tw_timer_t *timer = NULL;
+
+	assert(NULL != wheel);
+
+	timer = (tw_timer_t *)malloc(sizeof(tw_timer_t));
+	if(NULL == timer)
+	{
+		return NULL;
+	}
+
+	TimingWheelAddAt(wheel, timer, data, expire);
+	timer->is_owned = 1;
+
+	return timer;
+}
+
+tw_timer_t *TimingWheelAddAt(timing_wheel_t *wheel, void *memory, void *data,
+                             unsigned long expire)
+{
+	tw_timer_t *timer = (tw_timer_t *)memory;
+
+	assert(NULL != wheel);
+	assert(NULL != memory);
+
+	timer->data = data;
+	timer->expire = expire;
+	timer->is_owned = 0;
+	Place(wheel, timer);
+	++wheel->size;
+
+	return timer;
+}
+
+void *TimingWheelRemove(timing_wheel_t *wheel, tw_timer_t *timer)
+{
+	void *data = NULL;
+
+	assert(NULL != wheel);
+	assert(NULL != timer);
+
+	data = timer->data;
+	Unlink(wheel, timer);
+	--wheel->size;
+	if(timer->is_owned)
+	{
+		free(timer); timer = NULL;
+	}
+
+	return data;
+}
+
+void *TimingWheelPopExpired(timing_wheel_t *wheel, unsigned long now)
+{
+	assert(NULL != wheel);
+
+	for(;;)
+	{
+		tw_timer_t *slot = GetSlot(wheel, 0, wheel->current);
+
+		if(!IsSlotEmpty(slot))
+		{
+			return TimingWheelRemove(wheel, slot->next);
+		}
+
+		if(wheel->current >= now)
+		{
+			return NULL;
+		}
+
+		if(0 == wheel->size)
+		{
+			wheel->current = now;
+			return NULL;
+		}
+
+		/* nothing in level 0 - jump straight to the next cascade point */
+		if(0 == wheel->level_count[0])
+		{
+			unsigned long next_cascade = (wheel->current | TW_L0_MASK) + 1;
+
+			wheel->current = (next_cascade < now) ? next_cascade : now;
+		}
+		else
+		{
+			++wheel->current;
+		}
+
+		if(0 == (wheel->current & TW_L0_MASK))
+		{
+			Cascade(wheel);
+		}
+	}
+}
+
+unsigned long TimingWheelNextExpiry(const timing_wheel_t *wheel)
+{
+	unsigned long next = (unsigned long)-1;
+	unsigned long tick = 0;
+	int level = 1;
+
+	assert(NULL != wheel);
+
+	if(0 == wheel->size)
+	{
+		return wheel->current;
+	}
+
+	if(0 != wheel->level_count[0])
+	{
+		for(tick = wheel->current; tick < wheel->current + TW_L0_SLOTS; ++tick)
+		{
+			if(!IsSlotEmpty(GetSlot((timing_wheel_t *)wheel, 0, tick)))
+			{
+				next = tick;
+				break;
+			}
+		}
+	}
+
+	for(; level < TW_LEVELS; ++level)
+	{
+		unsigned long block = wheel->current >> LEVEL_SHIFT(level);
+		unsigned long k = 1;
+
+		if(0 == wheel->level_count[level])
+		{
+			continue;
+		}
+
+		for(; k <= TW_LN_SLOTS; ++k)
+		{
+			tick = (block + k) << LEVEL_SHIFT(level);
+			if(!IsSlotEmpty(GetSlot((timing_wheel_t *)wheel, level, tick)))
+			{
+				next = (tick < next) ? tick : next;
+				break;
+			}
+		}
+	}
+
+	return next;
+}
+
+void TimingWheelClear(timing_wheel_t *wheel, tw_action_t action, void *param)
+{
+	size_t idx = 0;
+
+	assert(NULL != wheel);
+
+	for(; idx < TW_SLOTS_TOTAL; ++idx)
+	{
+		tw_timer_t *slot = &wheel->slots[idx];
+
+		while(!IsSlotEmpty(slot))
+		{
+			void *data = TimingWheelRemove(wheel, slot->next);
+
+			if(NULL != action)
+			{
+				action(data, param);
+			}
+		}
+	}
+}
+
+size_t TimingWheelTimerSize(void)
+{
+	return sizeof(tw_timer_t);
+}
+
+size_t TimingWheelSize(const timing_wheel_t *wheel)
+{
+	assert(NULL != wheel);
+
+	return wheel->size;
+}
+
+int TimingWheelIsEmpty(const timing_wheel_t *wheel)
+{
+	assert(NULL != wheel);
+
+	return (0 == wheel->size);
+}
+
+/*----------------------------------------------------------------------------*/
+
+static tw_timer_t *GetSlot(timing_wheel_t *wheel, int level, unsigned long tick)
+{
+	if(0 == level)
+	{
+		return &wheel->slots[tick & TW_L0_MASK];
+	}
+
+	return &wheel->slots[TW_L0_SLOTS + (level - 1) * TW_LN_SLOTS +
+	                     ((tick >> LEVEL_SHIFT(level)) & TW_LN_MASK)];
+}
+
+static int IsSlotEmpty(const tw_timer_t *slot)
+{
+	return (slot->next == slot);
+}
+
+static void Link(tw_timer_t *slot, tw_timer_t *timer)
+{
+	timer->next = slot;
+	timer->prev = slot->prev;
+	slot->prev->next = timer;
+	slot->prev = timer;
+}
+
+static void Unlink(timing_wheel_t *wheel, tw_timer_t *timer)
+{
+	timer->prev->next = timer->next;
+	timer->next->prev = timer->prev;
+	--wheel->level_count[timer->level];
+}
+
+static void Place(timing_wheel_t *wheel, tw_timer_t *timer)
+{
+	unsigned long expire = timer->expire;
+	unsigned long delta = 0;
+	int level = 0;
+
+	if(expire < wheel->current)
+	{
+		expire = wheel->current;
+	}
+
+	delta = expire - wheel->current;
+	if(delta > TW_MAX_DELTA)
+	{
+		delta = TW_MAX_DELTA;
+		expire = wheel->current + delta;
+	}
+
+	while(level < TW_LEVELS - 1 && delta >= LEVEL_RANGE(level))
+	{
+		++level;
+	}
+
+	timer->level = level;
+	++wheel->level_count[level];
+	Link(GetSlot(wheel, level, expire), timer);
+}
+
+/* called when the current tick crosses a multiple of 256: the slot of the
+   new block on every level that just wrapped is moved to the levels below */
+static void Cascade(timing_wheel_t *wheel)
+{
+	int level = 1;
+
+	for(; level < TW_LEVELS; ++level)
+	{
+		tw_timer_t *slot = GetSlot(wheel, level, wheel->current);
+		tw_timer_t pending;
+
+		/* detach the slot first, re-placed timers may land in it again */
+		pending.next = &pending;
+		pending.prev = &pending;
+		if(!IsSlotEmpty(slot))
+		{
+			pending.next = slot->next;
+			pending.prev = slot->prev;
+			pending.next->prev = &pending;
+			pending.prev->next = &pending;
+			slot->next = slot;
+			slot->prev = slot;
+		}
+
+		while(!IsSlotEmpty(&pending))
+		{
+			tw_timer_t *timer = pending.next;
+
+			Unlink(wheel, timer);
+			Place(wheel, timer);
+		}
+
+		if(0 != ((wheel->current >> LEVEL_SHIFT(level)) & TW_LN_MASK))
+		{
+			break;
+		}
+	}
+}
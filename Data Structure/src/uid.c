@@ -5,26 +5,55 @@ Reviewer : Elior Nataf
 Infinity Labs OL95	
 *******************************************/
 
+#define _POSIX_C_SOURCE 200112L	/* pthread_once, pthread_atfork */
+
+#include <assert.h>	/* assert */
+#include <pthread.h>	/* pthread_once, pthread_atfork */
+
 #include "uid.h"
 
+/* the counter makes a uid unique inside the process, pid and the time the
+   process started make it unique between processes. pid and time are read
+   once (and again in a forked child), so UIDCreate does no system call */
 static size_t COUNTER = 0;
+static pid_t PROCESS_ID = 0;
+static time_t TIME_STAMP = 0;
+static pthread_once_t INIT_ONCE = PTHREAD_ONCE_INIT;
 ilrd_uid_t BAD_UID = {0};
 
+static void InitProcess(void);
+static void RefreshProcess(void);
+static ilrd_uid_t MakeUID(size_t number_id);
+
 ilrd_uid_t UIDCreate(void)
 {
-	ilrd_uid_t uid = {0};
+	pthread_once(&INIT_ONCE, InitProcess);
 	
-	uid.time_stamp = time(NULL);
-	uid.process_id = getpid();
-	uid.number_id = ++COUNTER;
+	return MakeUID(__atomic_add_fetch(&COUNTER, 1, __ATOMIC_RELAXED));
 	
-	if(0 == uid.time_stamp || 0 == uid.process_id)
+}
+
+int UIDCreateN(ilrd_uid_t *out, size_t n)
+{
+	size_t first = 0;
+	size_t idx = 0;
+	
+	assert(NULL != out);
+	
+	pthread_once(&INIT_ONCE, InitProcess);
+	
+	first = __atomic_fetch_add(&COUNTER, n, __ATOMIC_RELAXED) + 1;
+	
+	for(; idx < n; ++idx)
 	{
-		return BAD_UID;
+		out[idx] = MakeUID(first + idx);
+		if(UIDIsSame(BAD_UID, out[idx]))
+		{
+			return 1;
+		}
 	}
 	
-	return uid;
-	
+	return 0;
 }
 
 int UIDIsSame(ilrd_uid_t uid1, ilrd_uid_t uid2)
@@ -35,3 +64,32 @@ int UIDIsSame(ilrd_uid_t uid1, ilrd_uid_t uid2)
 	
 	
 }
+
+static void InitProcess(void)
+{
+	RefreshProcess();
+	pthread_atfork(NULL, NULL, RefreshProcess);
+}
+
+/* also runs in the child after fork */
+static void RefreshProcess(void)
+{
+	__atomic_store_n(&TIME_STAMP, time(NULL), __ATOMIC_RELAXED);
+	__atomic_store_n(&PROCESS_ID, getpid(), __ATOMIC_RELAXED);
+}
+
+static ilrd_uid_t MakeUID(size_t number_id)
+{
+	ilrd_uid_t uid = {0};
+	
+	uid.time_stamp = __atomic_load_n(&TIME_STAMP, __ATOMIC_RELAXED);
+	uid.process_id = __atomic_load_n(&PROCESS_ID, __ATOMIC_RELAXED);
+	uid.number_id = number_id;
+	
+	if(0 == uid.time_stamp || 0 == uid.process_id)
+	{
+		return BAD_UID;
+	}
+	
+	return uid;
+}
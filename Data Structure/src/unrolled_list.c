@@ -0,0 +1,403 @@
+/********************************************
+File name : unrolled_list.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <assert.h>	/* assert */
+#include <stdlib.h>	/* malloc, free */
+#include <string.h>	/* memmove, memcpy */
+
+#include "unrolled_list.h" /* unrolled list API */
+
+#define HALF_NODE (ULIST_NODE_CAPACITY / 2)
+
+struct ulist_node
+{
+	ulist_node_t *next;
+	ulist_node_t *prev;
+	size_t count;
+	void *data[ULIST_NODE_CAPACITY];
+};
+
+struct unrolled_list
+{
+	ulist_node_t sentinel;
+	size_t size;
+};
+
+static ulist_node_t *AddNodeAfter(ulist_node_t *prev);
+static void RemoveNode(ulist_node_t *node);
+static int IsSentinel(const ulist_node_t *node);
+static ulist_iter_t MakeIter(ulist_node_t *node, size_t index);
+
+/*----------------------------------------------------------------------------*/
+
+ulist_t *UListCreate(void)
+{
+	ulist_t *list = (ulist_t *)malloc(sizeof(ulist_t));
+
+	if(NULL == list)
+	{
+		return NULL;
+	}
+
+	list->sentinel.next = &list->sentinel;
+	list->sentinel.prev = &list->sentinel;
+	list->sentinel.count = 0;
+	list->size = 0;
+
+	return list;
+}
+
+void UListDestroy(ulist_t *list)
+{
+	assert(NULL != list);
+
+	while(!IsSentinel(list->sentinel.next))
+	{
+		RemoveNode(list->sentinel.next);
+	}
+
+	free(list); list = NULL;
+}
+
+ulist_iter_t UListInsert(ulist_t *list, ulist_iter_t where, const void *data)
+{
+	ulist_node_t *node = where.node;
+	size_t index = where.index;
+
+	assert(NULL != list);
+	assert(NULL != node);
+	assert(NULL != data);
+
+	/* at the start of a node, the end of the previous one is the same place
+	   and keeps the nodes packed (this is also how the end is appended to) */
+	if(0 == index && !IsSentinel(node->prev) &&
+	   ULIST_NODE_CAPACITY != node->prev->count)
+	{
+		node = node->prev;
+		index = node->count;
+	}
+	else if(IsSentinel(node))
+	{
+		node = AddNodeAfter(node->prev);
+		if(NULL == node)
+		{
+			return UListEnd(list);
+		}
+	}
+	else if(ULIST_NODE_CAPACITY == node->count)
+	{
+		ulist_node_t *half = AddNodeAfter(node);
+		if(NULL == half)
+		{
+			return UListEnd(list);
+		}
+
+		memcpy(half->data, node->data + HALF_NODE,
+		       (ULIST_NODE_CAPACITY - HALF_NODE) * sizeof(void *));
+		half->count = ULIST_NODE_CAPACITY - HALF_NODE;
+		node->count = HALF_NODE;
+
+		if(index > HALF_NODE)
+		{
+			node = half;
+			index -= HALF_NODE;
+		}
+	}
+
+	memmove(node->data + index + 1, node->data + index,
+	        (node->count - index) * sizeof(void *));
+	node->data[index] = (void *)data;
+	++node->count;
+	++list->size;
+
+	return MakeIter(node, index);
+}
+
+ulist_iter_t UListRemove(ulist_t *list, ulist_iter_t iter)
+{
+	ulist_node_t *node = iter.node;
+	ulist_node_t *next = NULL;
+
+	assert(NULL != list);
+	assert(NULL != node);
+	assert(iter.index < node->count);
+
+	--node->count;
+	--list->size;
+	memmove(node->data + iter.index, node->data + iter.index + 1,
+	        (node->count - iter.index) * sizeof(void *));
+
+	next = node->next;
+	if(0 == node->count)
+	{
+		RemoveNode(node);
+		return MakeIter(next, 0);
+	}
+
+	/* two neighbours that fit in half a node become one */
+	if(!IsSentinel(next) && node->count + next->count <= HALF_NODE)
+	{
+		memcpy(node->data + node->count, next->data,
+		       next->count * sizeof(void *));
+		node->count += next->count;
+		RemoveNode(next);
+	}
+
+	if(iter.index < node->count)
+	{
+		return iter;
+	}
+
+	return MakeIter(node->next, 0);
+}
+
+int UListPushBack(ulist_t *list, const void *data)
+{
+	assert(NULL != list);
+
+	return IsSentinel(UListInsert(list, UListEnd(list), data).node);
+}
+
+int UListPushFront(ulist_t *list, const void *data)
+{
+	assert(NULL != list);
+
+	return IsSentinel(UListInsert(list, UListBegin(list), data).node);
+}
+
+void *UListPopBack(ulist_t *list)
+{
+	ulist_iter_t last = {NULL, 0};
+	void *data = NULL;
+
+	assert(NULL != list);
+	assert(!UListIsEmpty(list));
+
+	last = UListPrevIter(UListEnd(list));
+	data = UListGetData(last);
+	UListRemove(list, last);
+
+	return data;
+}
+
+void *UListPopFront(ulist_t *list)
+{
+	ulist_iter_t first = {NULL, 0};
+	void *data = NULL;
+
+	assert(NULL != list);
+	assert(!UListIsEmpty(list));
+
+	first = UListBegin(list);
+	data = UListGetData(first);
+	UListRemove(list, first);
+
+	return data;
+}
+
+int UListSplice(ulist_t *dest_list, ulist_iter_t dest_iter, ulist_t *src_list,
+                ulist_iter_t from, ulist_iter_t to)
+{
+	ulist_iter_t runner = from;
+	size_t count = 0;
+
+	assert(NULL != dest_list);
+	assert(NULL != src_list);
+	assert(dest_list != src_list);
+
+	/* removing from src moves the elements after from, to is invalid after
+	   the first move, so the range is counted first */
+	for(; !UListIsSameIter(runner, to); runner = UListNextIter(runner))
+	{
+		++count;
+	}
+
+	for(; 0 < count; --count)
+	{
+		ulist_iter_t moved = UListInsert(dest_list, dest_iter,
+		                                 UListGetData(from));
+		if(IsSentinel(moved.node))
+		{
+			return 1;
+		}
+
+		dest_iter = UListNextIter(moved);
+		from = UListRemove(src_list, from);
+	}
+
+	return 0;
+}
+
+ulist_iter_t UListFind(ulist_iter_t from, ulist_iter_t to,
+                       ulist_is_match_t is_match, const void *data)
+{
+	assert(NULL != from.node);
+	assert(NULL != to.node);
+	assert(NULL != is_match);
+
+	while(!UListIsSameIter(from, to))
+	{
+		size_t end = (from.node == to.node) ? to.index : from.node->count;
+
+		for(; from.index < end; ++from.index)
+		{
+			if(is_match(from.node->data[from.index], data))
+			{
+				return from;
+			}
+		}
+
+		if(from.node != to.node)
+		{
+			from = MakeIter(from.node->next, 0);
+		}
+	}
+
+	return to;
+}
+
+int UListForEach(ulist_iter_t from, ulist_iter_t to, ulist_action_t action,
+                 void *param)
+{
+	assert(NULL != from.node);
+	assert(NULL != to.node);
+	assert(NULL != action);
+
+	while(!UListIsSameIter(from, to))
+	{
+		size_t end = (from.node == to.node) ? to.index : from.node->count;
+
+		for(; from.index < end; ++from.index)
+		{
+			if(0 != action(from.node->data[from.index], param))
+			{
+				return 1;
+			}
+		}
+
+		if(from.node != to.node)
+		{
+			from = MakeIter(from.node->next, 0);
+		}
+	}
+
+	return 0;
+}
+
+size_t UListSize(const ulist_t *list)
+{
+	assert(NULL != list);
+
+	return list->size;
+}
+
+int UListIsEmpty(const ulist_t *list)
+{
+	assert(NULL != list);
+
+	return (0 == list->size);
+}
+
+ulist_iter_t UListBegin(const ulist_t *list)
+{
+	assert(NULL != list);
+
+	return MakeIter(list->sentinel.next, 0);
+}
+
+ulist_iter_t UListEnd(const ulist_t *list)
+{
+	assert(NULL != list);
+
+	return MakeIter((ulist_node_t *)&list->sentinel, 0);
+}
+
+ulist_iter_t UListNextIter(ulist_iter_t iter)
+{
+	assert(NULL != iter.node);
+	assert(iter.index < iter.node->count);
+
+	if(iter.index + 1 < iter.node->count)
+	{
+		return MakeIter(iter.node, iter.index + 1);
+	}
+
+	return MakeIter(iter.node->next, 0);
+}
+
+ulist_iter_t UListPrevIter(ulist_iter_t iter)
+{
+	assert(NULL != iter.node);
+	assert(0 < iter.index || !IsSentinel(iter.node->prev));
+
+	if(0 < iter.index)
+	{
+		return MakeIter(iter.node, iter.index - 1);
+	}
+
+	return MakeIter(iter.node->prev, iter.node->prev->count - 1);
+}
+
+void *UListGetData(ulist_iter_t iter)
+{
+	assert(NULL != iter.node);
+	assert(iter.index < iter.node->count);
+
+	return iter.node->data[iter.index];
+}
+
+int UListIsSameIter(ulist_iter_t iter1, ulist_iter_t iter2)
+{
+	return (iter1.node == iter2.node && iter1.index == iter2.index);
+}
+
+/*----------------------------------------------------------------------------*/
+
+static ulist_node_t *AddNodeAfter(ulist_node_t *prev)
+{
+	ulist_node_t *node = (ulist_node_t *)malloc(sizeof(ulist_node_t));
+
+	if(NULL == node)
+	{
+		return NULL;
+	}
+
+	node->count = 0;
+	node->prev = prev;
+	node->next = prev->next;
+	prev->next->prev = node;
+	prev->next = node;
+
+	return node;
+}
+
+static void RemoveNode(ulist_node_t *node)
+{
+	node->prev->next = node->next;
+	node->next->prev = node->prev;
+
+	free(node);
+}
+
+/* every node but the sentinel holds at least one element */
+static int IsSentinel(const ulist_node_t *node)
+{
+	return (0 == node->count);
+}
+
+static ulist_iter_t MakeIter(ulist_node_t *node, size_t index)
+{
+	ulist_iter_t iter = {NULL, 0};
+
+	iter.node = node;
+	iter.index = index;
+
+	return iter;
+}
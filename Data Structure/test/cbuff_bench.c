@@ -0,0 +1,79 @@
+/********************************************
+File name : cbuff_bench.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* CBuffWrite / CBuffRead throughput, 2 GB pushed through the buffer in
+   chunks of different sizes, power of two and other capacities.
+   make bench NAME=cbuff */
+
+#define _POSIX_C_SOURCE 200112L	/* clock_gettime */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <string.h>	/* memset */
+#include <time.h>	/* clock_gettime */
+
+#include "cbuff.h"	/* circular buffer API */
+
+#define TOTAL_BYTES ((size_t)1 << 31)
+#define MAX_CHUNK (65536)
+
+static char in[MAX_CHUNK];
+static char out[MAX_CHUNK];
+
+static double Now(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static void Bench(size_t capacity, size_t chunk)
+{
+	c_buff_t *cbuff = CBuffCreate(capacity);
+	size_t total = 0;
+	double time = 0;
+
+	if(NULL == cbuff)
+	{
+		printf("capacity %lu: creation failed\n", (unsigned long)capacity);
+		return;
+	}
+
+	/* the capacity is not a multiple of the chunk, so the copies wrap */
+	time = Now();
+	while(total < TOTAL_BYTES)
+	{
+		size_t written = CBuffWrite(cbuff, in, chunk);
+
+		total += CBuffRead(cbuff, out, written);
+	}
+	time = Now() - time;
+
+	printf("capacity %8lu, chunk %6lu B: %8.2f GB/s%s\n",
+	       (unsigned long)capacity, (unsigned long)chunk,
+	       total / time / 1e9, (out[chunk / 2] == in[chunk / 2]) ? "" :
+	       " (data mismatch)");
+
+	CBuffDestroy(cbuff);
+}
+
+int main(void)
+{
+	memset(in, 'x', sizeof(in));
+
+	Bench((size_t)1 << 20, 60000);
+	Bench(1000000, 60000);
+	Bench(4096, 1000);
+	Bench(4096, 100);
+	Bench(4000, 100);
+
+	return 0;
+}
@@ -0,0 +1,200 @@
+/********************************************
+File name : cbuff_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+#define _POSIX_C_SOURCE 200112L	/* sched_yield */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <string.h>	/* memcmp */
+#include <sched.h>	/* sched_yield */
+#include <pthread.h>	/* pthread_create, pthread_join */
+
+#include "cbuff.h"	/* circular buffer API */
+
+#define STREAM_BYTES ((size_t)1 << 20)
+#define MAX_CHUNK (700)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			__atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED); \
+		} \
+	} \
+	while(0)
+
+typedef struct stream
+{
+	c_buff_t *cbuff;
+	size_t chunk;
+} stream_t;
+
+/* the n-th byte of a stream, not periodic in any power of two */
+static unsigned char StreamByte(size_t n)
+{
+	return (unsigned char)(n % 251);
+}
+
+static void *Writer(void *param)
+{
+	stream_t *stream = (stream_t *)param;
+	unsigned char buf[MAX_CHUNK];
+	size_t sent = 0;
+
+	while(sent < STREAM_BYTES)
+	{
+		size_t n = stream->chunk;
+		size_t i = 0;
+
+		n = (n < STREAM_BYTES - sent) ? n : STREAM_BYTES - sent;
+		for(i = 0; i < n; ++i)
+		{
+			buf[i] = StreamByte(sent + i);
+		}
+
+		/* a full buffer takes less, the rest is sent again */
+		n = CBuffWrite(stream->cbuff, buf, n);
+		if(0 == n)
+		{
+			sched_yield();
+		}
+		sent += n;
+	}
+
+	return NULL;
+}
+
+/* for every start position: a write that wraps past the end of the buffer
+   (two copies), then reads that split it at another place. Writes and
+   reads are cut to the free space and to the stored bytes. */
+static void TestWrap(c_buff_t *cbuff)
+{
+	size_t capacity = CBuffCapacity(cbuff);
+	unsigned char in[MAX_CHUNK];
+	unsigned char out[MAX_CHUNK];
+	size_t start = 0;
+	size_t i = 0;
+
+	for(i = 0; i < capacity + 1; ++i)
+	{
+		in[i] = StreamByte(i * 7 + 1);
+	}
+
+	for(start = 0; start < capacity; ++start)
+	{
+		size_t first = (start * 5) % capacity;
+
+		/* move the read and write positions to start */
+		CHECK(start == CBuffWrite(cbuff, in, start));
+		CHECK(start == CBuffRead(cbuff, out, start));
+		CHECK(CBuffIsEmpty(cbuff));
+
+		CHECK(capacity == CBuffWrite(cbuff, in, capacity + 1));
+		CHECK(0 == CBuffFreeSpace(cbuff));
+		CHECK(0 == CBuffWrite(cbuff, in, 1));
+
+		CHECK(first == CBuffRead(cbuff, out, first));
+		CHECK(capacity - first == CBuffRead(cbuff, out + first, capacity));
+		CHECK(0 == CBuffRead(cbuff, out, 1));
+		CHECK(0 == memcmp(in, out, capacity));
+		CHECK(CBuffIsEmpty(cbuff));
+		CHECK(capacity == CBuffFreeSpace(cbuff));
+	}
+}
+
+static void TestWrapBoth(size_t capacity)
+{
+	c_buff_t *cbuff = CBuffCreate(capacity);
+	c_buff_t *spsc = CBuffCreateSPSC(capacity);
+
+	CHECK(NULL != cbuff && NULL != spsc);
+	if(NULL != cbuff)
+	{
+		CHECK(capacity == CBuffCapacity(cbuff));
+		TestWrap(cbuff);
+		CBuffDestroy(cbuff);
+	}
+	if(NULL != spsc)
+	{
+		CHECK(capacity == CBuffCapacity(spsc));
+		TestWrap(spsc);
+		CBuffDestroy(spsc);
+	}
+}
+
+/* one writer and one reader with no lock, every byte arrives once and in
+   order. The chunks are odd sized so the copies wrap at every place */
+static void TestSPSC(size_t capacity, size_t chunk)
+{
+	c_buff_t *cbuff = CBuffCreateSPSC(capacity);
+	unsigned char buf[MAX_CHUNK];
+	pthread_t writer;
+	stream_t stream;
+	size_t received = 0;
+	size_t errors = 0;
+
+	CHECK(NULL != cbuff);
+	if(NULL == cbuff)
+	{
+		return;
+	}
+
+	stream.cbuff = cbuff;
+	stream.chunk = chunk;
+	CHECK(0 == pthread_create(&writer, NULL, Writer, &stream));
+
+	while(received < STREAM_BYTES)
+	{
+		size_t n = CBuffRead(cbuff, buf, (chunk * 3) % MAX_CHUNK + 1);
+		size_t i = 0;
+
+		for(i = 0; i < n; ++i)
+		{
+			errors += (StreamByte(received + i) != buf[i]);
+		}
+		received += n;
+		if(0 == n)
+		{
+			sched_yield();
+		}
+	}
+
+	pthread_join(writer, NULL);
+
+	CHECK(0 == errors);
+	CHECK(CBuffIsEmpty(cbuff));
+	CHECK(capacity == CBuffFreeSpace(cbuff));
+
+	CBuffDestroy(cbuff);
+}
+
+int main(void)
+{
+	TestWrapBoth(1);
+	TestWrapBoth(10);
+	TestWrapBoth(16);
+	TestWrapBoth(MAX_CHUNK - 1);
+	TestWrapBoth(512);
+
+	TestSPSC(64, 7);
+	TestSPSC(100, 33);
+	TestSPSC(4096, 699);
+	TestSPSC(3, 5);
+
+	if(0 == failures)
+	{
+		printf("cbuff: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
@@ -0,0 +1,158 @@
+/********************************************
+File name : concurrent_hash_table_bench.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* ConcurrentHashTableFind throughput with 1, 2, 4 .. up to the number of
+   online cores threads, every thread looks up its own random keys.
+   make bench NAME=concurrent_hash_table */
+
+#define _POSIX_C_SOURCE 200112L	/* clock_gettime, sysconf */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* malloc, free */
+#include <time.h>	/* clock_gettime */
+#include <unistd.h>	/* sysconf */
+#include <pthread.h>	/* pthread_create, pthread_join */
+
+#include "concurrent_hash_table.h"	/* concurrent hash table API */
+#include "hash_functions.h"		/* HashSizeT */
+
+#define N_KEYS ((size_t)1 << 20)
+#define FINDS_PER_THREAD ((size_t)1 << 22)
+#define MAX_THREADS (256)
+
+typedef struct reader
+{
+	pthread_t thread;
+	const concurrent_hash_table_t *table;
+	const size_t *keys;
+	size_t seed;
+	size_t found;
+} reader_t;
+
+static int IsMatch(const void *hash_data, const void *input_data)
+{
+	return (*(const size_t *)hash_data == *(const size_t *)input_data);
+}
+
+static double Now(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* xorshift, rand() is not thread safe */
+static size_t Random(size_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+static void *Reader(void *param)
+{
+	reader_t *reader = (reader_t *)param;
+	size_t i = 0;
+
+	for(; i < FINDS_PER_THREAD; ++i)
+	{
+		size_t idx = Random(&reader->seed) % N_KEYS;
+
+		reader->found += (NULL != ConcurrentHashTableFind(reader->table,
+		                                               reader->keys + idx));
+	}
+
+	return NULL;
+}
+
+static void Bench(const concurrent_hash_table_t *table, const size_t *keys,
+                  size_t n_threads, double *base)
+{
+	reader_t readers[MAX_THREADS];
+	size_t found = 0;
+	size_t i = 0;
+	double time = Now();
+	double rate = 0;
+
+	for(i = 0; i < n_threads; ++i)
+	{
+		readers[i].table = table;
+		readers[i].keys = keys;
+		readers[i].seed = 2463534242UL + i * 7919;
+		readers[i].found = 0;
+		if(0 != pthread_create(&readers[i].thread, NULL, Reader,
+		                       readers + i))
+		{
+			printf("pthread_create failed\n");
+			n_threads = i;
+			break;
+		}
+	}
+
+	for(i = 0; i < n_threads; ++i)
+	{
+		pthread_join(readers[i].thread, NULL);
+		found += readers[i].found;
+	}
+	time = Now() - time;
+
+	rate = n_threads * FINDS_PER_THREAD / time;
+	*base = (0 == *base) ? rate : *base;
+	printf("%3lu threads: %8.2f M finds/s, %5.2fx one thread%s\n",
+	       (unsigned long)n_threads, rate / 1e6, rate / *base,
+	       (found == n_threads * FINDS_PER_THREAD) ? "" : " (key missing)");
+}
+
+int main(void)
+{
+	size_t *keys = (size_t *)malloc(N_KEYS * sizeof(size_t));
+	concurrent_hash_table_t *table = ConcurrentHashTableCreate(N_KEYS,
+	                                                   HashSizeT, IsMatch);
+	long n_cores = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t state = 88172645463325252UL;
+	size_t n_threads = 1;
+	double base = 0;
+	size_t i = 0;
+
+	if(NULL == keys || NULL == table)
+	{
+		printf("allocation failed\n");
+		free(keys);
+		if(NULL != table)
+		{
+			ConcurrentHashTableDestroy(table);
+		}
+		return 1;
+	}
+
+	n_cores = (n_cores < 1) ? 1 : n_cores;
+	n_cores = (n_cores > MAX_THREADS) ? MAX_THREADS : n_cores;
+
+	for(i = 0; i < N_KEYS; ++i)
+	{
+		keys[i] = Random(&state);
+		ConcurrentHashTableInsert(table, keys + i);
+	}
+
+	for(; n_threads < (size_t)n_cores; n_threads *= 2)
+	{
+		Bench(table, keys, n_threads, &base);
+	}
+	Bench(table, keys, (size_t)n_cores, &base);
+
+	ConcurrentHashTableDestroy(table);
+	free(keys);
+
+	return 0;
+}
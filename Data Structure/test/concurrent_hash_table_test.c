@@ -0,0 +1,165 @@
+/********************************************
+File name : concurrent_hash_table_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* malloc, free */
+#include <pthread.h>	/* pthread_create, pthread_join */
+
+#include "concurrent_hash_table.h"	/* concurrent hash table API */
+#include "hash_functions.h"		/* HashSizeT */
+
+#define N_THREADS (4)
+#define KEYS_PER_THREAD (20000)
+#define N_KEYS (N_THREADS * KEYS_PER_THREAD)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			__atomic_fetch_add(&failures, 1, __ATOMIC_RELAXED); \
+		} \
+	} \
+	while(0)
+
+typedef struct worker
+{
+	pthread_t thread;
+	concurrent_hash_table_t *table;
+	size_t *keys;
+	size_t *stable;
+	size_t n_stable;
+} worker_t;
+
+static int IsMatch(const void *hash_data, const void *input_data)
+{
+	return (*(const size_t *)hash_data == *(const size_t *)input_data);
+}
+
+static int SumKeys(void *data, void *param)
+{
+	*(size_t *)param += *(const size_t *)data;
+
+	return 0;
+}
+
+/* inserts its own keys, removes every other one, and all the time looks up
+   the keys that were in the table before the threads started */
+static void *Worker(void *param)
+{
+	worker_t *worker = (worker_t *)param;
+	size_t i = 0;
+
+	for(i = 0; i < KEYS_PER_THREAD; ++i)
+	{
+		CHECK(0 == ConcurrentHashTableInsert(worker->table,
+		                                     worker->keys + i));
+		CHECK(worker->stable + i % worker->n_stable ==
+		      ConcurrentHashTableFind(worker->table,
+		                              worker->stable + i % worker->n_stable));
+	}
+
+	for(i = 0; i < KEYS_PER_THREAD; i += 2)
+	{
+		ConcurrentHashTableRemove(worker->table, worker->keys + i);
+		CHECK(NULL == ConcurrentHashTableFind(worker->table,
+		                                      worker->keys + i));
+		CHECK(worker->keys + i + 1 ==
+		      ConcurrentHashTableFind(worker->table, worker->keys + i + 1));
+	}
+
+	return NULL;
+}
+
+/* one shard puts every thread on the same lock */
+static void TestThreads(size_t n_shards, size_t n_stable)
+{
+	size_t *keys = (size_t *)malloc((N_KEYS + n_stable) * sizeof(size_t));
+	concurrent_hash_table_t *table = ConcurrentHashTableCreateShards(64,
+	                                        n_shards, HashSizeT, IsMatch);
+	worker_t workers[N_THREADS];
+	size_t expected_sum = 0;
+	size_t sum = 0;
+	size_t i = 0;
+
+	CHECK(NULL != keys && NULL != table);
+	if(NULL == keys || NULL == table)
+	{
+		free(keys);
+		if(NULL != table)
+		{
+			ConcurrentHashTableDestroy(table);
+		}
+		return;
+	}
+
+	for(i = 0; i < N_KEYS + n_stable; ++i)
+	{
+		keys[i] = i * 2654435761UL + 17;
+	}
+
+	for(i = N_KEYS; i < N_KEYS + n_stable; ++i)
+	{
+		CHECK(0 == ConcurrentHashTableInsert(table, keys + i));
+		expected_sum += keys[i];
+	}
+
+	for(i = 0; i < N_THREADS; ++i)
+	{
+		workers[i].table = table;
+		workers[i].keys = keys + i * KEYS_PER_THREAD;
+		workers[i].stable = keys + N_KEYS;
+		workers[i].n_stable = n_stable;
+		CHECK(0 == pthread_create(&workers[i].thread, NULL, Worker,
+		                          workers + i));
+	}
+	for(i = 0; i < N_THREADS; ++i)
+	{
+		pthread_join(workers[i].thread, NULL);
+	}
+
+	CHECK(N_KEYS / 2 + n_stable == ConcurrentHashTableSize(table));
+	for(i = 0; i < N_KEYS; ++i)
+	{
+		void *found = ConcurrentHashTableFind(table, keys + i);
+
+		CHECK((0 == i % 2) ? (NULL == found) : (keys + i == found));
+		expected_sum += (0 == i % 2) ? 0 : keys[i];
+	}
+
+	CHECK(0 == ConcurrentHashTableForEach(table, SumKeys, &sum));
+	CHECK(expected_sum == sum);
+
+	for(i = 0; i < N_KEYS + n_stable; ++i)
+	{
+		ConcurrentHashTableRemove(table, keys + i);
+	}
+	CHECK(ConcurrentHashTableIsEmpty(table));
+
+	ConcurrentHashTableDestroy(table);
+	free(keys);
+}
+
+int main(void)
+{
+	TestThreads(1, 1000);
+	TestThreads(7, 1);
+	TestThreads(CHT_DEFAULT_SHARDS, 1000);
+
+	if(0 == failures)
+	{
+		printf("concurrent hash table: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
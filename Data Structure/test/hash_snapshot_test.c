@@ -0,0 +1,273 @@
+/********************************************
+File name : hash_snapshot_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+#define _POSIX_C_SOURCE 200809L	/* truncate, stat */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf, sprintf, fopen, fwrite, fclose, remove */
+#include <stdlib.h>	/* malloc, free */
+#include <string.h>	/* memcpy, memcmp */
+#include <unistd.h>	/* truncate */
+#include <sys/stat.h>	/* stat */
+
+#include "hash_table.h"		/* hash table API */
+#include "hash_snapshot.h"	/* hash snapshot API */
+#include "hash_functions.h"	/* HashSizeT */
+
+#define N_KEYS (5000)
+#define SNAP_PATH ("hash_snapshot_test.snap")
+#define BAD_PATH ("hash_snapshot_test.bad")
+#define VALUE_SIZE (32)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} \
+	while(0)
+
+static int IsMatch(const void *hash_data, const void *input_data)
+{
+	return (*(const size_t *)hash_data == *(const size_t *)input_data);
+}
+
+/* record: the key, then "<version>:<key>" without the terminating zero, so
+   records have different lengths */
+static size_t MakeValue(size_t key, size_t version, char *value)
+{
+	return sprintf(value, "%lu:%lu", (unsigned long)version,
+	               (unsigned long)key);
+}
+
+static size_t Encode(const void *data, void *buf, size_t buf_size,
+                     void *param)
+{
+	char value[VALUE_SIZE];
+	size_t key = *(const size_t *)data;
+	size_t len = sizeof(size_t) + MakeValue(key, *(size_t *)param, value);
+
+	if(buf_size >= len)
+	{
+		memcpy(buf, &key, sizeof(size_t));
+		memcpy((char *)buf + sizeof(size_t), value, len - sizeof(size_t));
+	}
+
+	return len;
+}
+
+static int IsRecordMatch(const void *record, size_t len, const void *key)
+{
+	return (sizeof(size_t) <= len &&
+	        0 == memcmp(record, key, sizeof(size_t)));
+}
+
+static int CountRecords(const void *record, size_t len, void *param)
+{
+	(void)record;
+	(void)len;
+	++*(size_t *)param;
+
+	return 0;
+}
+
+/* every key is found with the record of version, keys not saved are not */
+static void CheckSnapshot(const hash_snapshot_t *snap, const size_t *keys,
+                          size_t n, size_t version)
+{
+	size_t counted = 0;
+	size_t missing = 0;
+	size_t i = 0;
+
+	CHECK(n == HashSnapshotSize(snap));
+
+	for(i = 0; i < n; ++i)
+	{
+		char value[VALUE_SIZE];
+		size_t value_len = MakeValue(keys[i], version, value);
+		size_t len = 0;
+		const char *record = (const char *)HashSnapshotFind(snap, keys + i,
+		                                                    &len);
+
+		CHECK(NULL != record);
+		if(NULL != record)
+		{
+			CHECK(sizeof(size_t) + value_len == len);
+			CHECK(0 == memcmp(record, keys + i, sizeof(size_t)));
+			CHECK(0 == memcmp(record + sizeof(size_t), value, value_len));
+		}
+	}
+
+	missing = keys[0] + 1;
+	CHECK(NULL == HashSnapshotFind(snap, &missing, NULL));
+
+	CHECK(0 == HashSnapshotForEach(snap, CountRecords, &counted));
+	CHECK(n == counted);
+}
+
+/* a snapshot that is open keeps its records when the file is saved again */
+static void TestRoundTrip(void)
+{
+	size_t *keys = (size_t *)malloc(N_KEYS * sizeof(size_t));
+	hash_table_t *table = HashTableCreate(16, HashSizeT, IsMatch);
+	hash_snapshot_t *old_snap = NULL;
+	hash_snapshot_t *new_snap = NULL;
+	size_t version = 1;
+	size_t i = 0;
+
+	CHECK(NULL != keys && NULL != table);
+	if(NULL == keys || NULL == table)
+	{
+		free(keys);
+		if(NULL != table)
+		{
+			HashTableDestroy(table);
+		}
+		return;
+	}
+
+	for(i = 0; i < N_KEYS; ++i)
+	{
+		keys[i] = i * 2654435761UL + 2;
+		CHECK(0 == HashTableInsert(table, keys + i));
+	}
+
+	CHECK(0 == HashSnapshotSave(table, SNAP_PATH, HashSizeT, Encode,
+	                            &version));
+	old_snap = HashSnapshotOpen(SNAP_PATH, HashSizeT, IsRecordMatch);
+	CHECK(NULL != old_snap);
+
+	version = 2;
+	CHECK(0 == HashSnapshotSave(table, SNAP_PATH, HashSizeT, Encode,
+	                            &version));
+	new_snap = HashSnapshotOpen(SNAP_PATH, HashSizeT, IsRecordMatch);
+	CHECK(NULL != new_snap);
+
+	if(NULL != old_snap)
+	{
+		CheckSnapshot(old_snap, keys, N_KEYS, 1);
+		HashSnapshotClose(old_snap);
+	}
+	if(NULL != new_snap)
+	{
+		CheckSnapshot(new_snap, keys, N_KEYS, 2);
+		HashSnapshotClose(new_snap);
+	}
+
+	HashTableDestroy(table);
+	free(keys);
+}
+
+static void TestEmpty(void)
+{
+	hash_table_t *table = HashTableCreate(16, HashSizeT, IsMatch);
+	hash_snapshot_t *snap = NULL;
+	size_t version = 1;
+	size_t key = 7;
+	size_t counted = 0;
+
+	CHECK(NULL != table);
+	if(NULL == table)
+	{
+		return;
+	}
+
+	CHECK(0 == HashSnapshotSave(table, SNAP_PATH, HashSizeT, Encode,
+	                            &version));
+	snap = HashSnapshotOpen(SNAP_PATH, HashSizeT, IsRecordMatch);
+	CHECK(NULL != snap);
+	if(NULL != snap)
+	{
+		CHECK(0 == HashSnapshotSize(snap));
+		CHECK(NULL == HashSnapshotFind(snap, &key, NULL));
+		CHECK(0 == HashSnapshotForEach(snap, CountRecords, &counted));
+		CHECK(0 == counted);
+		HashSnapshotClose(snap);
+	}
+
+	HashTableDestroy(table);
+}
+
+/* truncated, garbage and missing files are refused at open, a save that
+   can not create its file fails */
+static void TestBadFiles(void)
+{
+	hash_table_t *table = HashTableCreate(16, HashSizeT, IsMatch);
+	struct stat file_stat;
+	size_t keys[100];
+	size_t version = 1;
+	FILE *file = NULL;
+	size_t i = 0;
+
+	CHECK(NULL != table);
+	if(NULL == table)
+	{
+		return;
+	}
+
+	for(i = 0; i < 100; ++i)
+	{
+		keys[i] = i;
+		CHECK(0 == HashTableInsert(table, keys + i));
+	}
+
+	CHECK(0 == HashSnapshotSave(table, SNAP_PATH, HashSizeT, Encode,
+	                            &version));
+
+	/* cut off the end of the last record, then the middle of the entries,
+	   then everything after the magic */
+	CHECK(0 == stat(SNAP_PATH, &file_stat));
+	CHECK(0 == truncate(SNAP_PATH, file_stat.st_size - 1));
+	CHECK(NULL == HashSnapshotOpen(SNAP_PATH, HashSizeT, IsRecordMatch));
+	CHECK(0 == truncate(SNAP_PATH, file_stat.st_size / 2));
+	CHECK(NULL == HashSnapshotOpen(SNAP_PATH, HashSizeT, IsRecordMatch));
+	CHECK(0 == truncate(SNAP_PATH, 3 * sizeof(size_t)));
+	CHECK(NULL == HashSnapshotOpen(SNAP_PATH, HashSizeT, IsRecordMatch));
+
+	file = fopen(BAD_PATH, "wb");
+	CHECK(NULL != file);
+	if(NULL != file)
+	{
+		for(i = 0; i < 100; ++i)
+		{
+			fwrite(keys, sizeof(keys), 1, file);
+		}
+		fclose(file);
+		CHECK(NULL == HashSnapshotOpen(BAD_PATH, HashSizeT, IsRecordMatch));
+	}
+
+	CHECK(NULL == HashSnapshotOpen("no_such_dir/x.snap", HashSizeT,
+	                               IsRecordMatch));
+	CHECK(0 != HashSnapshotSave(table, "no_such_dir/x.snap", HashSizeT,
+	                            Encode, &version));
+
+	remove(BAD_PATH);
+	HashTableDestroy(table);
+}
+
+int main(void)
+{
+	TestRoundTrip();
+	TestEmpty();
+	TestBadFiles();
+
+	remove(SNAP_PATH);
+
+	if(0 == failures)
+	{
+		printf("hash snapshot: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
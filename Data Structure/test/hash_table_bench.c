@@ -0,0 +1,138 @@
+/********************************************
+File name : hash_table_bench.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* HashTableFind one key at a time against HashTableFindBatch, on a table
+   far bigger than the last level cache, keys looked up in random order.
+   make bench NAME=hash_table */
+
+#define _POSIX_C_SOURCE 200112L	/* clock_gettime */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* malloc, free */
+#include <time.h>	/* clock_gettime */
+
+#include "hash_table.h"		/* hash table API */
+#include "hash_functions.h"	/* HashSizeT */
+
+/* 4M entries, a few hundred MB of entries, buckets and keys */
+#define N_KEYS ((size_t)1 << 22)
+#define BATCH_SIZE (1024)
+
+static int IsMatch(const void *hash_data, const void *input_data)
+{
+	return (*(const size_t *)hash_data == *(const size_t *)input_data);
+}
+
+static double Now(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* xorshift, rand() has too few bits for the shuffle */
+static size_t Random(size_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 7;
+	*state ^= *state << 17;
+
+	return *state;
+}
+
+static void Bench(hash_backend_t backend, const char *name, size_t *keys,
+                  const void **order, void **out)
+{
+	hash_table_t *table = HashTableCreateBackend(N_KEYS, HashSizeT, IsMatch,
+	                                             backend);
+	size_t found = 0;
+	size_t i = 0;
+	double single = 0;
+	double batch = 0;
+
+	if(NULL == table)
+	{
+		printf("%s: table creation failed\n", name);
+		return;
+	}
+
+	for(i = 0; i < N_KEYS; ++i)
+	{
+		HashTableInsert(table, keys + i);
+	}
+
+	single = Now();
+	for(i = 0; i < N_KEYS; ++i)
+	{
+		found += (NULL != HashTableFind(table, order[i]));
+	}
+	single = Now() - single;
+
+	batch = Now();
+	for(i = 0; i < N_KEYS; i += BATCH_SIZE)
+	{
+		size_t idx = 0;
+
+		HashTableFindBatch(table, order + i, out, BATCH_SIZE);
+		for(idx = 0; idx < BATCH_SIZE; ++idx)
+		{
+			found += (NULL != out[idx]);
+		}
+	}
+	batch = Now() - batch;
+
+	printf("%-20s find %6.1f ns/key, batch %6.1f ns/key, speedup %.2fx"
+	       " (found %lu of %lu)\n", name, single * 1e9 / N_KEYS,
+	       batch * 1e9 / N_KEYS, single / batch, (unsigned long)found,
+	       (unsigned long)(2 * N_KEYS));
+
+	HashTableDestroy(table);
+}
+
+int main(void)
+{
+	size_t *keys = (size_t *)malloc(N_KEYS * sizeof(size_t));
+	const void **order = (const void **)malloc(N_KEYS * sizeof(void *));
+	void **out = (void **)malloc(BATCH_SIZE * sizeof(void *));
+	size_t state = 88172645463325252UL;
+	size_t i = 0;
+
+	if(NULL == keys || NULL == order || NULL == out)
+	{
+		printf("allocation failed\n");
+		free(keys); free(order); free(out);
+		return 1;
+	}
+
+	for(i = 0; i < N_KEYS; ++i)
+	{
+		keys[i] = Random(&state);
+		order[i] = keys + i;
+	}
+
+	/* random lookup order, consecutive keys must not share cache lines */
+	for(i = N_KEYS - 1; 0 < i; --i)
+	{
+		size_t other = Random(&state) % (i + 1);
+		const void *tmp = order[i];
+
+		order[i] = order[other];
+		order[other] = tmp;
+	}
+
+	Bench(HASH_CHAINING, "chaining", keys, order, out);
+	Bench(HASH_OPEN_ADDRESSING, "open addressing", keys, order, out);
+
+	free(keys); free(order); free(out);
+
+	return 0;
+}
@@ -0,0 +1,164 @@
+/********************************************
+File name : hash_table_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* malloc, free */
+
+#include "hash_table.h"		/* hash table API */
+#include "hash_functions.h"	/* HashSizeT */
+
+#define N_KEYS (100000)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} \
+	while(0)
+
+static int IsMatch(const void *hash_data, const void *input_data)
+{
+	return (*(const size_t *)hash_data == *(const size_t *)input_data);
+}
+
+/* every key lands in a handful of buckets, long probes and chains */
+static size_t BadHash(const void *data)
+{
+	return *(const size_t *)data % 4;
+}
+
+/* inserts keys[0..n), removes every third one and checks the rest are found
+   and counted, with a max load low enough to grow many times. With a bad
+   hash open addressing may refuse keys (probe too long), the size must
+   still match the keys that went in. */
+static void TestGrowth(hash_backend_t backend, hash_function_t hash_func,
+                       double max_load, size_t n, int must_insert_all)
+{
+	size_t *keys = (size_t *)malloc(n * sizeof(size_t));
+	char *is_in = (char *)malloc(n);
+	hash_table_t *table = HashTableCreateBackend(8, hash_func, IsMatch,
+	                                             backend);
+	size_t i = 0;
+	size_t inserted = 0;
+	size_t found = 0;
+
+	CHECK(NULL != keys && NULL != is_in && NULL != table);
+	if(NULL == keys || NULL == is_in || NULL == table)
+	{
+		free(keys);
+		free(is_in);
+		return;
+	}
+
+	HashTableSetMaxLoad(table, max_load);
+
+	for(i = 0; i < n; ++i)
+	{
+		keys[i] = i * 7919 + 1;
+		is_in[i] = (0 == HashTableInsert(table, &keys[i]));
+		inserted += is_in[i];
+	}
+	CHECK(!must_insert_all || n == inserted);
+	CHECK(inserted == HashTableSize(table));
+
+	for(i = 0, found = 0; i < n; ++i)
+	{
+		found += (is_in[i] && &keys[i] == HashTableFind(table, &keys[i]));
+	}
+	CHECK(inserted == found);
+
+	for(i = 0; i < n; i += 3)
+	{
+		HashTableRemove(table, &keys[i]);
+		inserted -= is_in[i];
+		is_in[i] = 0;
+	}
+	CHECK(inserted == HashTableSize(table));
+
+	for(i = 0, found = 0; i < n; ++i)
+	{
+		found += (NULL != HashTableFind(table, &keys[i]));
+	}
+	CHECK(inserted == found);
+
+	HashTableDestroy(table);
+	free(is_in);
+	free(keys);
+}
+
+/* the growth in progress must be done before the load reaches the next
+   one, otherwise the table stays smaller than max_load allows (or one
+   insert moves the whole table). While growing, chaining counts the
+   buckets of both arrays (new + half of it). */
+static void TestLoadBound(hash_backend_t backend, double max_load, size_t n)
+{
+	size_t *keys = (size_t *)malloc(n * sizeof(size_t));
+	hash_table_t *table = HashTableCreateBackend(8, HashSizeT, IsMatch,
+	                                             backend);
+	size_t i = 0;
+
+	CHECK(NULL != keys && NULL != table);
+	if(NULL == keys || NULL == table)
+	{
+		free(keys);
+		return;
+	}
+
+	HashTableSetMaxLoad(table, max_load);
+
+	for(i = 0; i < n; ++i)
+	{
+		keys[i] = i * 7919 + 1;
+		CHECK(0 == HashTableInsert(table, &keys[i]));
+
+		if(0 == i % 97)
+		{
+			hash_stats_t stats;
+			size_t buckets = 0;
+
+			HashTableStats(table, &stats);
+			buckets = stats.buckets;
+			if(0 != (buckets & (buckets - 1)))
+			{
+				buckets = buckets / 3 * 2;
+			}
+			CHECK(stats.size <= max_load * buckets + 1);
+		}
+	}
+
+	HashTableDestroy(table);
+	free(keys);
+}
+
+int main(void)
+{
+	TestGrowth(HASH_OPEN_ADDRESSING, HashSizeT, 0.1, N_KEYS, 1);
+	TestGrowth(HASH_OPEN_ADDRESSING, HashSizeT, 0.95, N_KEYS, 1);
+	TestGrowth(HASH_OPEN_ADDRESSING, BadHash, 0.1, 2000, 0);
+	TestGrowth(HASH_CHAINING, HashSizeT, 0.1, N_KEYS, 1);
+	TestGrowth(HASH_CHAINING, BadHash, 1.0, 2000, 1);
+	TestLoadBound(HASH_CHAINING, 0.1, 20000);
+	TestLoadBound(HASH_CHAINING, 0.75, 20000);
+	TestLoadBound(HASH_OPEN_ADDRESSING, 0.1, 20000);
+	TestLoadBound(HASH_OPEN_ADDRESSING, 0.5, 20000);
+
+	if(0 == failures)
+	{
+		printf("hash table: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
@@ -0,0 +1,259 @@
+/********************************************
+File name : heap_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* rand, srand */
+
+#include "heap.h"	/* heap API */
+
+#define N_ITEMS (5000)
+#define N_KEYS (16)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} \
+	while(0)
+
+typedef struct item
+{
+	int key;
+	size_t order;
+	size_t index;
+} item_t;
+
+/* smaller key first */
+static int Cmp(const void *new_data, const void *existing_data)
+{
+	return ((const item_t *)existing_data)->key -
+	       ((const item_t *)new_data)->key;
+}
+
+static int IsMatch(const void *data, const void *param)
+{
+	return (data == param);
+}
+
+static void SetIndex(void *data, size_t index)
+{
+	((item_t *)data)->index = index;
+}
+
+/* few distinct keys, so most of the pops are ties */
+static void FillItems(item_t *items, size_t n)
+{
+	size_t i = 0;
+
+	for(; i < n; ++i)
+	{
+		items[i].key = rand() % N_KEYS;
+		items[i].order = i;
+		items[i].index = HEAP_NO_INDEX;
+	}
+}
+
+/* pops everything, keys must not go down and equal keys must come out in
+   the order they went in */
+static void CheckPopOrder(heap_t *heap, size_t expected)
+{
+	item_t *prev = NULL;
+	size_t popped = 0;
+
+	while(!HeapIsEmpty(heap))
+	{
+		item_t *item = (item_t *)HeapPop(heap);
+
+		if(NULL != prev)
+		{
+			CHECK(prev->key <= item->key);
+			CHECK(prev->key != item->key || prev->order < item->order);
+		}
+		prev = item;
+		++popped;
+	}
+
+	CHECK(expected == popped);
+	CHECK(0 == HeapSize(heap));
+	CHECK(NULL == HeapPeek(heap));
+}
+
+static void TestFIFO(void)
+{
+	static item_t items[N_ITEMS];
+	heap_t *heap = HeapCreate(Cmp);
+	size_t i = 0;
+
+	CHECK(NULL != heap);
+	if(NULL == heap)
+	{
+		return;
+	}
+
+	FillItems(items, N_ITEMS);
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		CHECK(0 == HeapPush(heap, items + i));
+	}
+	CHECK(N_ITEMS == HeapSize(heap));
+	CheckPopOrder(heap, N_ITEMS);
+
+	HeapDestroy(heap);
+}
+
+/* a batch into an empty heap is rebuilt bottom up, a small batch into a big
+   heap is pushed one by one, ties must stay FIFO across both */
+static void TestPushMany(void)
+{
+	static item_t items[N_ITEMS];
+	static void *ptrs[N_ITEMS];
+	heap_t *heap = HeapCreate(Cmp);
+	size_t big = N_ITEMS - 100;
+	size_t i = 0;
+
+	CHECK(NULL != heap);
+	if(NULL == heap)
+	{
+		return;
+	}
+
+	FillItems(items, N_ITEMS);
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		ptrs[i] = items + i;
+	}
+
+	CHECK(0 == HeapPushMany(heap, ptrs, big));
+	CHECK(0 == HeapPushMany(heap, ptrs + big, N_ITEMS - big));
+	CHECK(N_ITEMS == HeapSize(heap));
+	CheckPopOrder(heap, N_ITEMS);
+
+	CHECK(0 == HeapPushMany(heap, ptrs, 0));
+	CHECK(HeapIsEmpty(heap));
+
+	HeapDestroy(heap);
+}
+
+/* set_index must always report the real position: remove and re-key by it
+   and check the pop order still holds */
+static void TestIndexed(void)
+{
+	static item_t items[N_ITEMS];
+	heap_t *heap = HeapCreateIndexed(Cmp, SetIndex);
+	size_t left = N_ITEMS;
+	size_t i = 0;
+
+	CHECK(NULL != heap);
+	if(NULL == heap)
+	{
+		return;
+	}
+
+	FillItems(items, N_ITEMS);
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		CHECK(0 == HeapPush(heap, items + i));
+		CHECK(HEAP_NO_INDEX != items[i].index);
+	}
+
+	/* remove every fifth item by its index */
+	for(i = 0; i < N_ITEMS; i += 5)
+	{
+		CHECK(items + i == HeapRemoveAt(heap, items[i].index));
+		CHECK(HEAP_NO_INDEX == items[i].index);
+		--left;
+	}
+
+	/* move every third one that is still in, up or down. A re-keyed item
+	   counts as pushed again, so it goes after items with the same key */
+	for(i = 1; i < N_ITEMS; i += 3)
+	{
+		if(HEAP_NO_INDEX != items[i].index)
+		{
+			items[i].key = (0 == i % 2) ? -1 : N_KEYS;
+			items[i].order += N_ITEMS;
+			HeapUpdateAt(heap, items[i].index);
+		}
+	}
+
+	CHECK(left == HeapSize(heap));
+	CHECK(-1 == ((item_t *)HeapPeek(heap))->key);
+	CheckPopOrder(heap, left);
+
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		CHECK(HEAP_NO_INDEX == items[i].index);
+	}
+
+	HeapDestroy(heap);
+}
+
+static void TestRemoveClear(void)
+{
+	static item_t items[N_ITEMS];
+	heap_t *heap = HeapCreateIndexed(Cmp, SetIndex);
+	size_t i = 0;
+
+	CHECK(NULL != heap);
+	if(NULL == heap)
+	{
+		return;
+	}
+
+	FillItems(items, N_ITEMS);
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		CHECK(0 == HeapPush(heap, items + i));
+	}
+
+	CHECK(items + 7 == HeapRemove(heap, IsMatch, items + 7));
+	CHECK(NULL == HeapRemove(heap, IsMatch, items + 7));
+	CHECK(N_ITEMS - 1 == HeapSize(heap));
+
+	HeapClear(heap);
+	CHECK(HeapIsEmpty(heap));
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		CHECK(HEAP_NO_INDEX == items[i].index);
+	}
+
+	/* the heap is usable after a clear */
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		items[i].order = i;
+		CHECK(0 == HeapPush(heap, items + i));
+	}
+	CheckPopOrder(heap, N_ITEMS);
+
+	HeapDestroy(heap);
+}
+
+int main(void)
+{
+	srand(95);
+
+	TestFIFO();
+	TestPushMany();
+	TestIndexed();
+	TestRemoveClear();
+
+	if(0 == failures)
+	{
+		printf("heap: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
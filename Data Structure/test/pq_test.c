@@ -0,0 +1,201 @@
+/********************************************
+File name : pq_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* rand, srand */
+
+#include "pq.h"	/* priority queue API */
+
+#define N_ITEMS (2000)
+#define N_KEYS (8)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} \
+	while(0)
+
+typedef struct item
+{
+	int key;
+	size_t order;
+	size_t index;
+} item_t;
+
+/* smaller key first */
+static int Cmp(const void *new_data, const void *existing_data)
+{
+	return ((const item_t *)existing_data)->key -
+	       ((const item_t *)new_data)->key;
+}
+
+static int IsMatch(const void *data, const void *params)
+{
+	return (data == params);
+}
+
+static void SetIndex(void *data, size_t index)
+{
+	((item_t *)data)->index = index;
+}
+
+static void FillItems(item_t *items, size_t n)
+{
+	size_t i = 0;
+
+	for(; i < n; ++i)
+	{
+		items[i].key = rand() % N_KEYS;
+		items[i].order = i;
+		items[i].index = PQ_NO_INDEX;
+	}
+}
+
+/* dequeues everything, keys must not go down and equal keys must come out
+   in the order they went in */
+static void CheckDequeueOrder(pq_t *pq, size_t expected)
+{
+	item_t *prev = NULL;
+	size_t dequeued = 0;
+
+	while(!PQIsEmpty(pq))
+	{
+		item_t *item = (item_t *)PQPeek(pq);
+
+		CHECK(item == PQDequeue(pq));
+		if(NULL != prev)
+		{
+			CHECK(prev->key <= item->key);
+			CHECK(prev->key != item->key || prev->order < item->order);
+		}
+		prev = item;
+		++dequeued;
+	}
+
+	CHECK(expected == dequeued);
+	CHECK(0 == PQSize(pq));
+}
+
+/* both backends must give the same FIFO order for ties, through single and
+   batch enqueues */
+static void TestBackend(pq_backend_t backend)
+{
+	static item_t items[N_ITEMS];
+	static void *ptrs[N_ITEMS];
+	pq_t *pq = PQCreateBackend(Cmp, backend);
+	size_t half = N_ITEMS / 2;
+	size_t i = 0;
+
+	CHECK(NULL != pq);
+	if(NULL == pq)
+	{
+		return;
+	}
+
+	FillItems(items, N_ITEMS);
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		ptrs[i] = items + i;
+	}
+
+	for(i = 0; i < half; ++i)
+	{
+		CHECK(0 == PQEnqueue(pq, items + i));
+	}
+	CHECK(0 == PQEnqueueMany(pq, ptrs + half, N_ITEMS - half));
+	CHECK(N_ITEMS == PQSize(pq));
+
+	CHECK(items + 3 == PQErase(pq, IsMatch, items + 3));
+	CHECK(NULL == PQErase(pq, IsMatch, items + 3));
+	CheckDequeueOrder(pq, N_ITEMS - 1);
+
+	for(i = 0; i < half; ++i)
+	{
+		CHECK(0 == PQEnqueue(pq, items + i));
+	}
+	PQClear(pq);
+	CHECK(PQIsEmpty(pq));
+
+	PQDestroy(pq);
+}
+
+/* the reported index must follow every element: erase and re-key by it and
+   check the rest of the order holds */
+static void TestAddressable(void)
+{
+	static item_t items[N_ITEMS];
+	pq_t *pq = PQCreateAddressable(Cmp, SetIndex);
+	size_t left = N_ITEMS;
+	size_t i = 0;
+
+	CHECK(NULL != pq);
+	if(NULL == pq)
+	{
+		return;
+	}
+
+	FillItems(items, N_ITEMS);
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		CHECK(0 == PQEnqueue(pq, items + i));
+	}
+
+	for(i = 0; i < N_ITEMS; i += 4)
+	{
+		CHECK(items + i == PQEraseAt(pq, items[i].index));
+		CHECK(PQ_NO_INDEX == items[i].index);
+		--left;
+	}
+
+	/* reschedule: a re-keyed item goes after items with the same key */
+	for(i = 1; i < N_ITEMS; i += 3)
+	{
+		if(PQ_NO_INDEX != items[i].index)
+		{
+			items[i].key = (0 == i % 2) ? -1 : N_KEYS;
+			items[i].order += N_ITEMS;
+			PQUpdateAt(pq, items[i].index);
+		}
+	}
+
+	CHECK(left == PQSize(pq));
+	CHECK(-1 == ((item_t *)PQPeek(pq))->key);
+	CheckDequeueOrder(pq, left);
+
+	for(i = 0; i < N_ITEMS; ++i)
+	{
+		CHECK(PQ_NO_INDEX == items[i].index);
+	}
+
+	PQDestroy(pq);
+}
+
+int main(void)
+{
+	srand(95);
+
+	TestBackend(PQ_SORTED_LIST);
+	TestBackend(PQ_HEAP);
+	TestAddressable();
+
+	if(0 == failures)
+	{
+		printf("pq: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
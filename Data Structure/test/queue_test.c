@@ -0,0 +1,177 @@
+/********************************************
+File name : queue_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* rand, srand */
+
+#include "queue.h"	/* queue API */
+
+#define N_VALUES (100000)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} \
+	while(0)
+
+static size_t values[N_VALUES];
+
+/* enqueues values[*next..*next + n) */
+static void EnqueueRun(queue_t *queue, size_t *next, size_t n)
+{
+	for(; 0 < n; --n, ++*next)
+	{
+		CHECK(0 == QueueEnqueue(queue, values + *next));
+	}
+}
+
+/* dequeues n values, they must be values[*first..*first + n) */
+static void DequeueRun(queue_t *queue, size_t *first, size_t n)
+{
+	for(; 0 < n; --n, ++*first)
+	{
+		CHECK(values + *first == QueuePeek(queue));
+		QueueDequeue(queue);
+	}
+}
+
+/* random runs of enqueues and dequeues, the head moves around the buffer
+   so it grows while the elements wrap past its end */
+static void TestWrapGrow(void)
+{
+	queue_t *queue = QueueCreate();
+	size_t next = 0;
+	size_t first = 0;
+
+	CHECK(NULL != queue);
+	if(NULL == queue)
+	{
+		return;
+	}
+
+	CHECK(NULL == QueuePeek(queue));
+
+	while(next < N_VALUES - 100)
+	{
+		size_t size = 0;
+
+		EnqueueRun(queue, &next, (size_t)rand() % 100);
+		size = next - first;
+		/* dequeue less than was added most of the times, so it grows */
+		DequeueRun(queue, &first, (size_t)rand() % (size + 1) *
+		                          (size_t)(rand() % 4) / 4);
+		CHECK(next - first == QueueSize(queue));
+	}
+
+	DequeueRun(queue, &first, next - first);
+	CHECK(QueueIsEmpty(queue));
+	CHECK(NULL == QueuePeek(queue));
+
+	QueueDestroy(queue);
+}
+
+/* a queue of size n whose head is at offset of its buffer */
+static queue_t *MakeQueue(size_t n, size_t offset, size_t *next)
+{
+	queue_t *queue = QueueCreate();
+	size_t first = *next;
+
+	if(NULL == queue)
+	{
+		return NULL;
+	}
+
+	EnqueueRun(queue, next, offset);
+	DequeueRun(queue, &first, offset);
+	EnqueueRun(queue, next, n);
+
+	return queue;
+}
+
+/* src and dest wrapped or not, with and without dest growing, the order
+   after the append is dest then src */
+static void TestAppend(size_t src_size, size_t src_offset, size_t dest_size,
+                       size_t dest_offset)
+{
+	size_t dest_next = 0;
+	queue_t *dest = MakeQueue(dest_size, dest_offset, &dest_next);
+	size_t src_next = dest_next;
+	queue_t *src = MakeQueue(src_size, src_offset, &src_next);
+	size_t dest_first = dest_offset;
+	size_t src_first = dest_next + src_offset;
+
+	CHECK(NULL != dest && NULL != src);
+	if(NULL == dest || NULL == src)
+	{
+		if(NULL != dest)
+		{
+			QueueDestroy(dest);
+		}
+		if(NULL != src)
+		{
+			QueueDestroy(src);
+		}
+		return;
+	}
+
+	CHECK(0 == QueueAppend(src, dest));
+	CHECK(QueueIsEmpty(src));
+	CHECK(dest_size + src_size == QueueSize(dest));
+
+	DequeueRun(dest, &dest_first, dest_size);
+	DequeueRun(dest, &src_first, src_size);
+	CHECK(QueueIsEmpty(dest));
+
+	/* both are usable after it */
+	EnqueueRun(src, &src_next, 20);
+	CHECK(0 == QueueAppend(src, dest));
+	src_first = src_next - 20;
+	DequeueRun(dest, &src_first, 20);
+	CHECK(QueueIsEmpty(dest));
+
+	QueueDestroy(dest);
+	QueueDestroy(src);
+}
+
+int main(void)
+{
+	size_t i = 0;
+
+	srand(95);
+	for(i = 0; i < N_VALUES; ++i)
+	{
+		values[i] = i;
+	}
+
+	TestWrapGrow();
+
+	/* capacities are 8, 16, 32 for these sizes */
+	TestAppend(5, 0, 5, 0);
+	TestAppend(5, 6, 5, 6);
+	TestAppend(12, 10, 3, 14);
+	TestAppend(7, 3, 25, 20);
+	TestAppend(100, 50, 100, 90);
+	TestAppend(0, 0, 10, 5);
+	TestAppend(10, 5, 0, 0);
+
+	if(0 == failures)
+	{
+		printf("queue: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
@@ -0,0 +1,302 @@
+/********************************************
+File name : timing_wheel_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* malloc, free, rand, srand */
+
+#include "timing_wheel.h"	/* timing wheel API */
+
+#define N_TIMERS (20000)
+#define START (12345UL)
+/* same as in timing_wheel.c, the furthest a timer is placed ahead */
+#define MAX_DELTA (0xFFFFFFFFUL)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} \
+	while(0)
+
+typedef struct item
+{
+	unsigned long expire;
+	int popped;
+} item_t;
+
+/* 31 random bits, rand() may give only 15 */
+static unsigned long Random(void)
+{
+	unsigned long high = (unsigned long)rand() << 16;
+
+	return (high ^ (unsigned long)rand()) & 0x7FFFFFFFUL;
+}
+
+static void CountAction(void *data, void *param)
+{
+	((item_t *)data)->popped = 1;
+	++*(size_t *)param;
+}
+
+/* pops everything due at now, every timer must come out at the first poll
+   that reaches its tick, not before and not later */
+static size_t PollUntil(timing_wheel_t *wheel, unsigned long prev_now,
+                        unsigned long now)
+{
+	item_t *item = NULL;
+	size_t popped = 0;
+
+	while(NULL != (item = (item_t *)TimingWheelPopExpired(wheel, now)))
+	{
+		CHECK(!item->popped);
+		CHECK(item->expire <= now);
+		CHECK(item->expire > prev_now);
+		item->popped = 1;
+		++popped;
+	}
+
+	return popped;
+}
+
+/* timers on every level and right on the level boundaries, polled in
+   random steps so the wheel cascades through all 5 levels */
+static void TestCascade(void)
+{
+	static const unsigned long edges[] =
+	{
+		1, 255, 256, 257, 16383, 16384, 16385, 1048575, 1048576, 1048577,
+		67108863, 67108864, 67108865, 2147483647
+	};
+	size_t n_edges = sizeof(edges) / sizeof(edges[0]);
+	item_t *items = (item_t *)malloc(N_TIMERS * sizeof(item_t));
+	timing_wheel_t *wheel = TimingWheelCreate(START);
+	unsigned long now = START;
+	unsigned long last = START;
+	size_t popped = 0;
+	size_t i = 0;
+
+	CHECK(NULL != items && NULL != wheel);
+	if(NULL == items || NULL == wheel)
+	{
+		free(items);
+		if(NULL != wheel)
+		{
+			TimingWheelDestroy(wheel);
+		}
+		return;
+	}
+
+	for(i = 0; i < N_TIMERS; ++i)
+	{
+		unsigned long delta = (i < n_edges) ? edges[i] :
+		                      Random() >> (rand() % 31);
+
+		delta += (0 == delta);
+		items[i].expire = START + delta;
+		items[i].popped = 0;
+		last = (items[i].expire > last) ? items[i].expire : last;
+		CHECK(NULL != TimingWheelAdd(wheel, items + i, items[i].expire));
+	}
+	CHECK(N_TIMERS == TimingWheelSize(wheel));
+
+	while(now < last)
+	{
+		unsigned long prev_now = now;
+
+		now += 1 + (Random() >> (rand() % 31)) % ((unsigned long)1 << 20);
+		popped += PollUntil(wheel, prev_now, now);
+	}
+
+	CHECK(N_TIMERS == popped);
+	CHECK(TimingWheelIsEmpty(wheel));
+
+	TimingWheelDestroy(wheel);
+	free(items);
+}
+
+/* a timer further than the wheel spans is parked at the edge and placed
+   again on every cascade, it must still expire at its own tick */
+static void TestClamp(void)
+{
+	timing_wheel_t *wheel = TimingWheelCreate(START);
+	item_t far;
+	item_t near;
+
+	CHECK(NULL != wheel);
+	if(NULL == wheel)
+	{
+		return;
+	}
+
+	far.expire = START + MAX_DELTA + 5000;
+	far.popped = 0;
+	near.expire = START + MAX_DELTA;
+	near.popped = 0;
+	CHECK(NULL != TimingWheelAdd(wheel, &far, far.expire));
+	CHECK(NULL != TimingWheelAdd(wheel, &near, near.expire));
+	CHECK(far.expire > TimingWheelNextExpiry(wheel));
+
+	CHECK(0 == PollUntil(wheel, START, near.expire - 1));
+	CHECK(1 == PollUntil(wheel, near.expire - 1, near.expire));
+	CHECK(near.popped);
+	CHECK(0 == PollUntil(wheel, near.expire, far.expire - 1));
+	CHECK(1 == PollUntil(wheel, far.expire - 1, far.expire));
+	CHECK(far.popped);
+	CHECK(TimingWheelIsEmpty(wheel));
+
+	TimingWheelDestroy(wheel);
+}
+
+/* a timer above level 0 is reported by the start of its slot, the caller
+   wakes up early, finds nothing and asks again */
+static void TestNextExpiry(void)
+{
+	timing_wheel_t *wheel = TimingWheelCreate(0);
+	item_t item;
+	unsigned long next = 0;
+
+	CHECK(NULL != wheel);
+	if(NULL == wheel)
+	{
+		return;
+	}
+
+	CHECK(0 == TimingWheelNextExpiry(wheel));
+
+	item.expire = 1000;
+	item.popped = 0;
+	CHECK(NULL != TimingWheelAdd(wheel, &item, item.expire));
+
+	next = TimingWheelNextExpiry(wheel);
+	CHECK(768 == next);
+	CHECK(NULL == TimingWheelPopExpired(wheel, next));
+	CHECK(1000 == TimingWheelNextExpiry(wheel));
+	CHECK(&item == TimingWheelPopExpired(wheel, 1000));
+
+	/* empty again: the current tick */
+	CHECK(1000 == TimingWheelNextExpiry(wheel));
+
+	/* a nearer timer in level 0 is exact */
+	item.expire = 1100;
+	CHECK(NULL != TimingWheelAdd(wheel, &item, item.expire));
+	CHECK(1100 == TimingWheelNextExpiry(wheel));
+	CHECK(&item == TimingWheelPopExpired(wheel, 2000));
+
+	TimingWheelDestroy(wheel);
+}
+
+/* due timers that were not popped yet, and timers added in the past, must
+   still be removable by their handle, owned or in user memory */
+static void TestRemoveExpired(void)
+{
+	timing_wheel_t *wheel = TimingWheelCreate(START);
+	char *memory = (char *)malloc(2 * TimingWheelTimerSize());
+	tw_timer_t *timers[6];
+	tw_timer_t *past = NULL;
+	item_t items[7];
+	item_t *item = NULL;
+	size_t cleared = 0;
+	size_t i = 0;
+
+	CHECK(NULL != wheel && NULL != memory);
+	if(NULL == wheel || NULL == memory)
+	{
+		free(memory);
+		if(NULL != wheel)
+		{
+			TimingWheelDestroy(wheel);
+		}
+		return;
+	}
+
+	/* 4 timers due at +300 (2 of them in user memory), 2 at +301 */
+	for(i = 0; i < 6; ++i)
+	{
+		items[i].expire = START + 300 + (4 <= i);
+		items[i].popped = 0;
+		timers[i] = (2 == i || 3 == i) ?
+		            TimingWheelAddAt(wheel, memory + (i - 2) *
+		                             TimingWheelTimerSize(), items + i,
+		                             items[i].expire) :
+		            TimingWheelAdd(wheel, items + i, items[i].expire);
+		CHECK(NULL != timers[i]);
+	}
+
+	item = (item_t *)TimingWheelPopExpired(wheel, START + 300);
+	CHECK(NULL != item && START + 300 == item->expire);
+	if(NULL == item)
+	{
+		TimingWheelDestroy(wheel);
+		free(memory);
+		return;
+	}
+	item->popped = 1;
+
+	for(i = 0; i < 4; ++i)
+	{
+		if(!items[i].popped)
+		{
+			CHECK(items + i == TimingWheelRemove(wheel, timers[i]));
+		}
+	}
+
+	/* already due when it is added */
+	items[6].expire = START;
+	items[6].popped = 0;
+	past = TimingWheelAdd(wheel, items + 6, items[6].expire);
+	CHECK(NULL != past);
+	CHECK(START + 300 == TimingWheelNextExpiry(wheel));
+	CHECK(items + 6 == TimingWheelRemove(wheel, past));
+
+	CHECK(2 == TimingWheelSize(wheel));
+	CHECK(NULL == TimingWheelPopExpired(wheel, START + 300));
+	CHECK(2 == PollUntil(wheel, START + 300, START + 301));
+	CHECK(TimingWheelIsEmpty(wheel));
+
+	/* the user memory may be reused once the timer is out */
+	for(i = 0; i < 4; ++i)
+	{
+		items[i].popped = 0;
+		timers[i] = (2 <= i) ?
+		            TimingWheelAddAt(wheel, memory + (i - 2) *
+		                             TimingWheelTimerSize(), items + i,
+		                             START + 100000 * i) :
+		            TimingWheelAdd(wheel, items + i, START + 100000 * i);
+	}
+	TimingWheelClear(wheel, CountAction, &cleared);
+	CHECK(4 == cleared);
+	CHECK(TimingWheelIsEmpty(wheel));
+
+	TimingWheelDestroy(wheel);
+	free(memory);
+}
+
+int main(void)
+{
+	srand(95);
+
+	TestCascade();
+	TestClamp();
+	TestNextExpiry();
+	TestRemoveExpired();
+
+	if(0 == failures)
+	{
+		printf("timing wheel: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
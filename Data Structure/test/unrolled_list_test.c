@@ -0,0 +1,343 @@
+/********************************************
+File name : unrolled_list_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* rand, srand */
+#include <string.h>	/* memmove */
+
+#include "unrolled_list.h"	/* unrolled list API */
+
+#define CAP (ULIST_NODE_CAPACITY)
+#define HALF (ULIST_NODE_CAPACITY / 2)
+#define MAX_ITEMS (3000)
+#define N_OPS (20000)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} \
+	while(0)
+
+static size_t values[MAX_ITEMS * 2];
+
+static int IsMatch(const void *data1, const void *data2)
+{
+	return (data1 == data2);
+}
+
+static int Sum(void *data, void *param)
+{
+	*(size_t *)param += *(size_t *)data;
+
+	return 0;
+}
+
+static ulist_iter_t IterAt(const ulist_t *list, size_t pos)
+{
+	ulist_iter_t iter = UListBegin(list);
+
+	for(; 0 < pos; --pos)
+	{
+		iter = UListNextIter(iter);
+	}
+
+	return iter;
+}
+
+/* the list holds model[0..n) in order both ways, and returns the number of
+   nodes it uses */
+static size_t CheckList(const ulist_t *list, void **model, size_t n)
+{
+	ulist_iter_t iter = UListBegin(list);
+	ulist_iter_t end = UListEnd(list);
+	ulist_node_t *node = NULL;
+	size_t in_node = 0;
+	size_t n_nodes = 0;
+	size_t i = 0;
+
+	CHECK(n == UListSize(list));
+	CHECK((0 == n) == UListIsEmpty(list));
+
+	for(i = 0; i < n && !UListIsSameIter(iter, end); ++i)
+	{
+		if(iter.node != node)
+		{
+			node = iter.node;
+			in_node = 0;
+			++n_nodes;
+		}
+		++in_node;
+		CHECK(in_node <= CAP);
+		CHECK(model[i] == UListGetData(iter));
+		iter = UListNextIter(iter);
+	}
+	CHECK(n == i);
+	CHECK(UListIsSameIter(iter, end));
+
+	for(i = n; 0 < i; --i)
+	{
+		iter = UListPrevIter(iter);
+		CHECK(model[i - 1] == UListGetData(iter));
+	}
+
+	return n_nodes;
+}
+
+/* random inserts, removes, pushes and pops at both ends, compared with an
+   array after every operation that may split or merge nodes */
+static void TestRandom(void)
+{
+	static void *model[MAX_ITEMS];
+	ulist_t *list = UListCreate();
+	size_t n = 0;
+	size_t op = 0;
+
+	CHECK(NULL != list);
+	if(NULL == list)
+	{
+		return;
+	}
+
+	for(op = 0; op < N_OPS; ++op)
+	{
+		/* grows at first, then shrinks to empty */
+		int is_add = (0 == n) || (MAX_ITEMS != n &&
+		             rand() % 100 < ((op < N_OPS / 2) ? 65 : 35));
+		size_t pos = (size_t)rand() % (n + is_add);
+		void *data = values + op % (MAX_ITEMS * 2);
+
+		if(is_add)
+		{
+			if(0 == op % 7)
+			{
+				CHECK(0 == UListPushBack(list, data));
+				pos = n;
+			}
+			else if(0 == op % 11)
+			{
+				CHECK(0 == UListPushFront(list, data));
+				pos = 0;
+			}
+			else
+			{
+				ulist_iter_t where = IterAt(list, pos);
+				ulist_iter_t added = UListInsert(list, where, data);
+
+				CHECK(data == UListGetData(added));
+			}
+			memmove(model + pos + 1, model + pos, (n - pos) * sizeof(void *));
+			model[pos] = data;
+			++n;
+		}
+		else
+		{
+			if(0 == op % 7)
+			{
+				CHECK(model[n - 1] == UListPopBack(list));
+				pos = n - 1;
+			}
+			else if(0 == op % 11)
+			{
+				CHECK(model[0] == UListPopFront(list));
+				pos = 0;
+			}
+			else
+			{
+				ulist_iter_t next = UListRemove(list, IterAt(list, pos));
+
+				CHECK((pos + 1 == n) ? UListIsSameIter(next, UListEnd(list)) :
+				      model[pos + 1] == UListGetData(next));
+			}
+			memmove(model + pos, model + pos + 1,
+			        (n - pos - 1) * sizeof(void *));
+			--n;
+		}
+
+		if(0 == op % 97 || n < 3 * CAP)
+		{
+			CheckList(list, model, n);
+		}
+	}
+
+	while(0 != n)
+	{
+		UListRemove(list, UListBegin(list));
+		--n;
+	}
+	CHECK(UListIsEmpty(list));
+
+	UListDestroy(list);
+}
+
+/* push back packs full nodes, an insert into a full node splits it in two
+   halves, removes merge two neighbours once they fit in half a node */
+static void TestSplitMerge(void)
+{
+	static void *model[3 * CAP];
+	ulist_t *list = UListCreate();
+	size_t n = 0;
+	size_t i = 0;
+
+	CHECK(NULL != list);
+	if(NULL == list)
+	{
+		return;
+	}
+
+	for(n = 0; n < 2 * CAP; ++n)
+	{
+		model[n] = values + n;
+		CHECK(0 == UListPushBack(list, model[n]));
+	}
+	CHECK(2 == CheckList(list, model, n));
+
+	/* into the middle of the first full node */
+	UListInsert(list, IterAt(list, 3), values + n);
+	memmove(model + 4, model + 3, (n - 3) * sizeof(void *));
+	model[3] = values + n;
+	++n;
+	CHECK(3 == CheckList(list, model, n));
+	CHECK(IterAt(list, HALF).node == UListBegin(list).node);
+	CHECK(IterAt(list, HALF + 1).node != UListBegin(list).node);
+
+	/* nodes are HALF + 1, HALF and CAP now. Drop the second one to a single
+	   element, then remove from the first until both fit in half a node */
+	for(i = 0; i < HALF - 1; ++i)
+	{
+		UListRemove(list, IterAt(list, HALF + 1));
+		memmove(model + HALF + 1, model + HALF + 2,
+		        (n - HALF - 2) * sizeof(void *));
+		--n;
+	}
+	CHECK(3 == CheckList(list, model, n));
+
+	CHECK(model[0] == UListPopFront(list));
+	memmove(model, model + 1, (n - 1) * sizeof(void *));
+	--n;
+	CHECK(3 == CheckList(list, model, n));
+
+	CHECK(model[0] == UListPopFront(list));
+	memmove(model, model + 1, (n - 1) * sizeof(void *));
+	--n;
+	CHECK(2 == CheckList(list, model, n));
+	CHECK(IterAt(list, HALF - 1).node == UListBegin(list).node);
+
+	while(0 != n)
+	{
+		CHECK(model[n - 1] == UListPopBack(list));
+		--n;
+	}
+	CHECK(0 == CheckList(list, model, n));
+
+	UListDestroy(list);
+}
+
+static void TestSpliceFind(void)
+{
+	static void *src_model[MAX_ITEMS];
+	static void *dest_model[MAX_ITEMS];
+	ulist_t *src = UListCreate();
+	ulist_t *dest = UListCreate();
+	size_t from = 100;
+	size_t to = 500;
+	size_t expected = 0;
+	size_t sum = 0;
+	size_t i = 0;
+
+	CHECK(NULL != src && NULL != dest);
+	if(NULL == src || NULL == dest)
+	{
+		if(NULL != src)
+		{
+			UListDestroy(src);
+		}
+		if(NULL != dest)
+		{
+			UListDestroy(dest);
+		}
+		return;
+	}
+
+	for(i = 0; i < 1000; ++i)
+	{
+		values[i] = i;
+		src_model[i] = values + i;
+		CHECK(0 == UListPushBack(src, values + i));
+	}
+	for(i = 0; i < 10; ++i)
+	{
+		dest_model[i] = values + 2000 + i;
+		CHECK(0 == UListPushBack(dest, values + 2000 + i));
+	}
+
+	/* [100, 500) of src into the middle of dest */
+	CHECK(0 == UListSplice(dest, IterAt(dest, 5), src, IterAt(src, from),
+	                       IterAt(src, to)));
+	memmove(dest_model + 5 + (to - from), dest_model + 5,
+	        5 * sizeof(void *));
+	for(i = from; i < to; ++i)
+	{
+		dest_model[5 + i - from] = src_model[i];
+	}
+	memmove(src_model + from, src_model + to, (1000 - to) * sizeof(void *));
+	CheckList(src, src_model, 1000 - (to - from));
+	CheckList(dest, dest_model, 10 + (to - from));
+
+	/* an empty range moves nothing */
+	CHECK(0 == UListSplice(dest, UListEnd(dest), src, UListBegin(src),
+	                       UListBegin(src)));
+	CHECK(10 + (to - from) == UListSize(dest));
+
+	/* found across node boundaries, not found outside the range */
+	CHECK(values + 300 == UListGetData(UListFind(UListBegin(dest),
+	                      UListEnd(dest), IsMatch, values + 300)));
+	CHECK(UListIsSameIter(IterAt(dest, 50), UListFind(UListBegin(dest),
+	                      IterAt(dest, 50), IsMatch, values + 300)));
+
+	CHECK(0 == UListForEach(IterAt(dest, 5), IterAt(dest, 5 + to - from),
+	                        Sum, &sum));
+	for(i = from; i < to; ++i)
+	{
+		expected += i;
+	}
+	CHECK(expected == sum);
+
+	/* the whole list, src ends empty */
+	CHECK(0 == UListSplice(dest, UListBegin(dest), src, UListBegin(src),
+	                       UListEnd(src)));
+	CHECK(UListIsEmpty(src));
+	CHECK(1000 + 10 == UListSize(dest));
+
+	UListDestroy(src);
+	UListDestroy(dest);
+}
+
+int main(void)
+{
+	srand(95);
+
+	TestRandom();
+	TestSplitMerge();
+	TestSpliceFind();
+
+	if(0 == failures)
+	{
+		printf("unrolled list: all tests passed\n");
+	}
+
+	return (0 != failures);
+}
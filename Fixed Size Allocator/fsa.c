@@ -11,12 +11,14 @@ Infinity Labs OL95
 
 #include "fsa.h"	/*fsa API's*/
 #include <assert.h>	/*assert*/
+#include <stdlib.h>	/*malloc, free*/
 
 #define FSA_SIZE sizeof(struct fsa)
 #define SIZE_OF_WORD sizeof(size_t)
 #define MEM_BLOCK_SIZE sizeof(struct mem_block)
 
 typedef struct mem_block block_t;
+typedef struct fsa_chunk chunk_t;
 
 struct fsa
 {
@@ -29,6 +31,25 @@ struct mem_block
     size_t next_free;
 };
 
+/* the fsa segment follows the chunk header */
+struct fsa_chunk
+{
+	chunk_t *next;
+	fsa_t *fsa;
+	char *end;
+	size_t count_free;
+};
+
+struct fsa_pool
+{
+	chunk_t *chunks;
+	chunk_t *current;
+	size_t block_size;
+	size_t next_chunk_blocks;
+};
+
+static chunk_t *AddChunk(fsa_pool_t *pool);
+
 static size_t BlockSizeWithAlignment(size_t block_size)
 {
 	return block_size + (SIZE_OF_WORD - (block_size % SIZE_OF_WORD)) % SIZE_OF_WORD;
@@ -138,5 +159,155 @@ size_t FSASuggestSize(size_t num_of_blocks, size_t block_size)
 }
 
 
+fsa_pool_t *FSAPoolCreate(size_t block_size, size_t initial_blocks)
+{
+	fsa_pool_t *pool = NULL;
+
+	assert(0 < initial_blocks);
+
+	pool = (fsa_pool_t *)malloc(sizeof(fsa_pool_t));
+	if (NULL == pool)
+	{
+		return NULL;
+	}
+
+	/* a free block holds the offset of the next free one */
+	pool->block_size = (block_size < SIZE_OF_WORD) ? SIZE_OF_WORD : block_size;
+	pool->next_chunk_blocks = initial_blocks;
+	pool->chunks = NULL;
+	pool->current = AddChunk(pool);
+	if (NULL == pool->current)
+	{
+		free(pool);
+		return NULL;
+	}
+
+	return pool;
+}
+
+
+void FSAPoolDestroy(fsa_pool_t *pool)
+{
+	assert(NULL != pool);
+
+	while (NULL != pool->chunks)
+	{
+		chunk_t *next = pool->chunks->next;
+
+		free(pool->chunks);
+		pool->chunks = next;
+	}
+
+	free(pool); pool = NULL;
+}
+
+
+void *FSAPoolAlloc(fsa_pool_t *pool)
+{
+	assert(NULL != pool);
+
+	if (0 == pool->current->count_free)
+	{
+		chunk_t *chunk = pool->chunks;
+
+		while (NULL != chunk && 0 == chunk->count_free)
+		{
+			chunk = chunk->next;
+		}
+
+		if (NULL == chunk)
+		{
+			chunk = AddChunk(pool);
+			if (NULL == chunk)
+			{
+				return NULL;
+			}
+		}
+
+		pool->current = chunk;
+	}
+
+	--pool->current->count_free;
+
+	return FSAAlloc(pool->current->fsa);
+}
+
+
+int FSAPoolReserve(fsa_pool_t *pool, size_t n_blocks)
+{
+	chunk_t *chunk = NULL;
+	size_t count_free = 0;
+
+	assert(NULL != pool);
 
+	for (chunk = pool->chunks; NULL != chunk; chunk = chunk->next)
+	{
+		count_free += chunk->count_free;
+	}
 
+	if (count_free >= n_blocks)
+	{
+		return 0;
+	}
+
+	if (n_blocks - count_free > pool->next_chunk_blocks)
+	{
+		pool->next_chunk_blocks = n_blocks - count_free;
+	}
+
+	return (NULL == AddChunk(pool));
+}
+
+
+void FSAPoolFree(fsa_pool_t *pool, void *allocated_mem)
+{
+	chunk_t *chunk = NULL;
+
+	assert(NULL != pool);
+
+	if (NULL == allocated_mem)
+	{
+		return;
+	}
+
+	chunk = pool->chunks;
+	while ((char *)allocated_mem < (char *)chunk->fsa ||
+	       (char *)allocated_mem >= chunk->end)
+	{
+		chunk = chunk->next;
+		assert(NULL != chunk);
+	}
+
+	FSAFree(chunk->fsa, allocated_mem);
+	++chunk->count_free;
+}
+
+
+size_t FSAPoolBlockSize(const fsa_pool_t *pool)
+{
+	assert(NULL != pool);
+
+	return pool->block_size;
+}
+
+
+static chunk_t *AddChunk(fsa_pool_t *pool)
+{
+	size_t segment_size = FSASuggestSize(pool->next_chunk_blocks,
+	                                     pool->block_size);
+	chunk_t *chunk = (chunk_t *)malloc(sizeof(chunk_t) + segment_size);
+
+	if (NULL == chunk)
+	{
+		return NULL;
+	}
+
+	chunk->fsa = FSAInit(chunk + 1, segment_size, pool->block_size);
+	chunk->end = (char *)(chunk + 1) + segment_size;
+	chunk->count_free = pool->next_chunk_blocks;
+	chunk->next = pool->chunks;
+	pool->chunks = chunk;
+	pool->next_chunk_blocks *= 2;
+
+	return chunk;
+}
@@ -17,6 +17,9 @@
 
 typedef struct fsa fsa_t;
 
+/* a pool of fsa segments that grows in chunks when all blocks are in use */
+typedef struct fsa_pool fsa_pool_t;
+
 /*--------------------------- Functions declarations ------------------------*/
 
 /* DESCRIPTION:
@@ -96,4 +99,90 @@ size_t FSACountFree(const fsa_t *fsa);
 size_t FSASuggestSize(size_t num_of_blocks, size_t block_size);
 
 
+/* DESCRIPTION:
+ * Function for creating a growable pool of fixed size blocks.
+ * Memory is taken from malloc in chunks, every chunk is managed by its own
+ * fsa. The first chunk holds initial_blocks blocks, every new chunk is twice
+ * as big as the previous one, so the number of chunks stays logarithmic.
+ * The FSAPoolDestroy function is required at end of use.
+ * Time complexity: O(initial_blocks)
+ *
+ * @param:
+ * size_t block_size:		requested block size
+ * size_t initial_blocks:	number of blocks in the first chunk
+ *
+ * @return:
+ * Returns *fsa_pool_t is success, else return NULL.
+ */
+fsa_pool_t *FSAPoolCreate(size_t block_size, size_t initial_blocks);
+
+
+/* DESCRIPTION:
+ * Function for destroying a pool and all of its chunks.
+ * All blocks that were allocated from the pool become invalid.
+ * Time complexity: O(number of chunks)
+ *
+ * @param:
+ * fsa_pool_t *pool:		pointer to pool
+ */
+void FSAPoolDestroy(fsa_pool_t *pool);
+
+
+/* DESCRIPTION:
+ * Function for allocating a block from the pool, a new chunk is added when
+ * all blocks are in use.
+ * Time complexity: O(1) amortized, O(number of chunks) worst case
+ *
+ * @param:
+ * fsa_pool_t *pool:		pointer to pool
+ *
+ * @return:
+ * Returns pointer to the block, NULL if a new chunk could not be allocated
+ */
+void *FSAPoolAlloc(fsa_pool_t *pool);
+
+
+/* DESCRIPTION:
+ * Function for making sure the next n_blocks allocations need no new
+ * memory. When the free blocks are not enough a single chunk is added for
+ * the missing ones (at least as big as the next chunk would be).
+ * Time complexity: O(number of chunks) + O(n_blocks) when a chunk is added
+ *
+ * @param:
+ * fsa_pool_t *pool:		pointer to pool
+ * size_t n_blocks:			number of blocks that will be allocated
+ *
+ * @return:
+ * Returns 0 on success, non-zero if the chunk could not be allocated
+ */
+int FSAPoolReserve(fsa_pool_t *pool, size_t n_blocks);
+
+
+/* DESCRIPTION:
+ * Function for returning a block to the pool. Chunks are kept for reuse.
+ * In case the block was not allocated from this pool,
+ * the behavior will be undefined.
+ * Time complexity: O(number of chunks)
+ *
+ * @param:
+ * fsa_pool_t *pool:		pointer to pool
+ * void *allocated_mem:		pointer to allocated block to be freed
+ */
+void FSAPoolFree(fsa_pool_t *pool, void *allocated_mem);
+
+
+/* DESCRIPTION:
+ * Function for getting the block size of a pool, at least the requested
+ * one.
+ * Time complexity: O(1)
+ *
+ * @param:
+ * const fsa_pool_t *pool:	pointer to pool
+ *
+ * @return:
+ * Returns the block size
+ */
+size_t FSAPoolBlockSize(const fsa_pool_t *pool);
+
+
 #endif /* __ILRD_OL95_FSA_H__ */
@@ -7,34 +7,162 @@
  * InfinityLabs OL95
 *****************************************************************************/
 
+#define _POSIX_C_SOURCE 200112L	/* clock_gettime, clock_nanosleep, pthread */
+
 /* 				External Libraries
 -------------------------------------------*/
 #include "pq.h"		/*pq API's*/
 #include "sched.h"	/*sched API's*/
 #include "task.h"	/*task API's*/
+#include "timing_wheel.h"	/*timing wheel API's*/
+#include "doubly_linked_list.h"	/*dlist API's*/
+#include "fsa.h"	/*fsa pool API's*/
 #include <assert.h>	/* assert*/
-#include <stdlib.h> /* malloc, free */
-
+#include <stdlib.h> /* malloc, calloc, free */
+#include <string.h> /* memset */
+#include <time.h>	/* clock_gettime, clock_nanosleep, time */
+#include <errno.h>	/* EINTR */
+#include <pthread.h>	/* pthread_create, mutex, cond */
 
+#define SCHED_INDEX_SIZE (1024) /* min buckets of the uid index, power of 2 */
+#define NS_PER_SEC (1000000000UL)
+#define NS_PER_USEC (1000UL)
+#define NS_PER_TICK (1000000UL) /* timing wheel tick - one millisecond */
+#define DISPATCH_BATCH (256) /* max tasks handed out per dispatcher wakeup */
+#define WORKER_BATCH (64) /* finished tasks a worker returns at once */
 
 /**********************************sched************************************/
+/* everything below thread / sched is protected by lock.
+   The owner takes tasks from the front of its deque, idle workers steal from
+   the back of the others. Finished one shot tasks are collected in done and
+   returned to the sched WORKER_BATCH at a time, so short tasks do not take
+   the sched lock one by one. A task that has to be rescheduled is returned
+   at once, before the worker starts another (maybe slow) task. */
+typedef struct done_task
+{
+	task_t *task;
+	int task_run_res;
+	int is_timed;
+	unsigned long lateness;
+	unsigned long run_time;
+} done_task_t;
+
+typedef struct worker
+{
+	pthread_t thread;
+	sched_t *sched;
+	pthread_mutex_t lock;
+	dlist_t *deque;
+	task_t *task;
+	done_task_t done[WORKER_BATCH];
+	size_t n_done;
+	int is_stopped;
+} worker_t;
+
+/* every field is protected by lock.
+   A task is always in exactly one place: the pending engine (pq / wheel),
+   current_task (SchedRun), or a worker deque, task or done list
+   (SchedRunParallel). in_flight counts the indexed tasks held by workers.
+   A task that is removed while it is executed is only taken out of
+   uid_index and is freed by its runner when the action returns.
+   uid_index is intrusive: the buckets are chains of tasks linked through
+   the last word of their blocks, so indexing a task allocates nothing.
+   The uids of a process are consecutive numbers, the low bits of number_id
+   pick the bucket.
+   Lock order: sched lock, then worker locks by ascending index. */
 struct scheduler
 {
+	sched_engine_t engine;
 	pq_t *pq;
+	timing_wheel_t *wheel;
+	task_t **uid_index;
+	size_t index_mask;
+	size_t index_count;
 	task_t *current_task;
 	int is_running;
+	int run_status;
+	pthread_mutex_t lock;
+	pthread_cond_t wakeup;
+	pthread_cond_t work_ready;
+	worker_t *workers;
+	size_t n_workers;
+	size_t in_flight;
+	size_t dispatched;
+	fsa_pool_t *pool;
+	int is_stats_enabled;
+	sched_stats_t stats;
 };
 
 static int FrequencyCmp(const void *new_task, const void *existing_task);
-static int IsUIDMatch(const void *data, const void *params);
-static void SleepTillNextExec(sched_t *sched);
-static int SetNextExecutionOfTask(sched_t *sched);
+static int InitSync(sched_t *sched);
+static size_t TimerOffset(void);
+static size_t NodeOffset(sched_engine_t engine);
+static size_t IndexOffset(sched_engine_t engine);
+static size_t TaskBlockSize(sched_engine_t engine);
+static int InitIndex(sched_t *sched, size_t n_tasks);
+static task_t **IndexLink(const sched_t *sched, task_t *task);
+static task_t **IndexBucket(task_t **buckets, size_t mask, ilrd_uid_t uid);
+static void IndexInsert(sched_t *sched, task_t *task);
+static task_t *IndexFind(const sched_t *sched, ilrd_uid_t uid);
+static void IndexRemove(sched_t *sched, ilrd_uid_t uid);
+static void IndexGrow(sched_t *sched);
+static task_t *AllocTask(sched_t *sched, unsigned long first_execution,
+                         unsigned long interval, int(*action)(void *params),
+                         void *params);
+static void FreeTask(sched_t *sched, task_t *task);
+static void DestroyTask(sched_t *sched, task_t *task);
+static void DestroyTaskAction(void *task, void *sched);
+static int IsIndexed(const sched_t *sched, const task_t *task);
+static int IsPending(const sched_t *sched, const task_t *task);
+static int QueueTask(sched_t *sched, task_t *task);
+static int QueueTasks(sched_t *sched, void *const *tasks, size_t n);
+static void EraseTask(sched_t *sched, task_t *task);
+static task_t *PopDueTask(sched_t *sched);
+static size_t PendingSize(const sched_t *sched);
+static void ClearPending(sched_t *sched);
+static int WaitTillNextExec(sched_t *sched);
+static void SleepUntil(unsigned long deadline);
+static void ToTimespec(unsigned long ns, struct timespec *ts);
+static int RescheduleTask(sched_t *sched, task_t *task);
+static int RunTask(task_t *task, done_task_t *done);
+static void RecordRun(sched_t *sched, const done_task_t *done);
+static void UpdateHighWater(sched_t *sched);
+static int CreateWorkers(sched_t *sched, size_t n_workers);
+static void DestroyWorkers(sched_t *sched);
+static int IsSameTask(const void *task1, const void *task2);
+static int RemoveFromWorkers(sched_t *sched, task_t *task);
+static void ClearWorkers(sched_t *sched);
+static int IsDue(const sched_t *sched, unsigned long now);
+static void Dispatch(sched_t *sched);
+static void StopWorkers(sched_t *sched);
+static task_t *TakeTask(worker_t *self);
+static task_t *StealTask(worker_t *self);
+static size_t CompleteTask(worker_t *self, const done_task_t *done);
+static void FlushDone(sched_t *sched, worker_t *worker);
+static void *WorkerRoutine(void *worker);
+static void ReturnWorkerTasks(sched_t *sched);
 
 
 /*******************************************************************************
                             SchedCreate                             
 *******************************************************************************/
 sched_t *SchedCreate(void)
+{
+	return SchedCreateEngine(SCHED_ENGINE_PQ);
+}
+
+/*******************************************************************************
+                            SchedCreateEngine                             
+*******************************************************************************/
+sched_t *SchedCreateEngine(sched_engine_t engine)
+{
+	return SchedCreatePooled(engine, 0);
+}
+
+/*******************************************************************************
+                            SchedCreatePooled
+*******************************************************************************/
+sched_t *SchedCreatePooled(sched_engine_t engine, size_t initial_tasks)
 {
 	sched_t *new_sched = (sched_t*) malloc (sizeof(sched_t));
 	
@@ -43,15 +171,71 @@ sched_t *SchedCreate(void)
 		return NULL;
 	}
 	
-	new_sched->pq = PQCreate(FrequencyCmp);
-	if(NULL == new_sched->pq)
+	new_sched->engine = engine;
+	new_sched->pq = NULL;
+	new_sched->wheel = NULL;
+	new_sched->pool = NULL;
+
+	if(0 != initial_tasks)
+	{
+		new_sched->pool = FSAPoolCreate(TaskBlockSize(engine), initial_tasks);
+		if(NULL == new_sched->pool)
+		{
+			free(new_sched);
+			return NULL;
+		}
+	}
+	
+	if(SCHED_ENGINE_WHEEL == engine)
+	{
+		new_sched->wheel = TimingWheelCreate(SchedTimeNs() / NS_PER_TICK);
+	}
+	else
+	{
+		new_sched->pq = PQCreateAddressable(FrequencyCmp, TaskSetPQIndex);
+	}
+	
+	if(NULL == new_sched->pq && NULL == new_sched->wheel)
+	{
+		if(NULL != new_sched->pool)
+		{
+			FSAPoolDestroy(new_sched->pool);
+		}
+		free(new_sched);
+		return NULL;
+	}
+	
+	/* sized for initial_tasks, a pooled sched that stays within it never
+	   allocates when a task is added */
+	new_sched->uid_index = NULL;
+	if(0 != InitIndex(new_sched, initial_tasks) || 0 != InitSync(new_sched))
 	{
+		free(new_sched->uid_index);
+		if(NULL != new_sched->wheel)
+		{
+			TimingWheelDestroy(new_sched->wheel);
+		}
+		else
+		{
+			PQDestroy(new_sched->pq);
+		}
+		if(NULL != new_sched->pool)
+		{
+			FSAPoolDestroy(new_sched->pool);
+		}
 		free(new_sched);
 		return NULL;
 	}
 	
 	new_sched->is_running = 0;
+	new_sched->run_status = 0;
 	new_sched->current_task = NULL;
+	new_sched->workers = NULL;
+	new_sched->n_workers = 0;
+	new_sched->in_flight = 0;
+	new_sched->dispatched = 0;
+	new_sched->is_stats_enabled = 0;
+	memset(&new_sched->stats, 0, sizeof(sched_stats_t));
 	
 	return new_sched;
 }
@@ -65,7 +249,22 @@ void SchedDestroy(sched_t *sched)
 	assert(NULL != sched);
 	
 	SchedClear(sched);
-	PQDestroy(sched->pq);
+	if(SCHED_ENGINE_WHEEL == sched->engine)
+	{
+		TimingWheelDestroy(sched->wheel);
+	}
+	else
+	{
+		PQDestroy(sched->pq);
+	}
+	free(sched->uid_index);
+	if(NULL != sched->pool)
+	{
+		FSAPoolDestroy(sched->pool);
+	}
+	pthread_cond_destroy(&sched->work_ready);
+	pthread_cond_destroy(&sched->wakeup);
+	pthread_mutex_destroy(&sched->lock);
 	free(sched); sched = NULL;
 }
 
@@ -77,26 +276,132 @@ ilrd_uid_t SchedAddTask(sched_t *sched,
 						size_t frequency_in_sec,
 						int(*action)(void *params),
 					    void *params)
+{
+	time_t now = time(NULL);
+	unsigned long first_execution_ns = SchedTimeNs();
+	
+	/* the wall clock is read once here, later jumps do not affect the task */
+	if(first_execution > now)
+	{
+		first_execution_ns += (unsigned long)difftime(first_execution, now) *
+		                      NS_PER_SEC;
+	}
+	
+	return SchedAddTaskNs(sched, first_execution_ns,
+	                      frequency_in_sec * NS_PER_SEC, action, params);
+}
+
+/*******************************************************************************
+                            SchedAddTaskNs                             
+*******************************************************************************/
+ilrd_uid_t SchedAddTaskNs(sched_t *sched, 
+						  unsigned long first_execution_ns, 
+						  unsigned long interval_ns,
+						  int(*action)(void *params),
+					      void *params)
 {
 	task_t *new_task = NULL;
+	ilrd_uid_t uid = BAD_UID;
 	
 	assert(NULL != sched);
 	assert(NULL != action);
 	
-	new_task = TaskCreate(first_execution, frequency_in_sec, action, params);
+	pthread_mutex_lock(&sched->lock);
+
+	/* under the lock, the pool is not thread safe */
+	new_task = AllocTask(sched, first_execution_ns, interval_ns, action, params);
 	if(NULL == new_task)
 	{
+		pthread_mutex_unlock(&sched->lock);
 		return BAD_UID;
 	}
-	
-	if( 1 == PQEnqueue(sched->pq, new_task))
+
+	IndexInsert(sched, new_task);
+	if(0 != QueueTask(sched, new_task))
 	{
-		TaskDestroy(new_task);
-		return BAD_UID;
+		DestroyTask(sched, new_task);
+	}
+	else
+	{
+		uid = TaskGetUID(new_task);
+		/* the new task may be due before the one the runner sleeps on */
+		pthread_cond_broadcast(&sched->wakeup);
 	}
 	
-	return TaskGetUID(new_task);
+	pthread_mutex_unlock(&sched->lock);
 	
+	return uid;
+}
+
+/*******************************************************************************
+                            SchedAddTasks                             
+*******************************************************************************/
+int SchedAddTasks(sched_t *sched, const task_spec_t *specs, size_t n,
+                  ilrd_uid_t *out_uids)
+{
+	void **tasks = NULL;
+	size_t idx = 0;
+	int status = 0;
+
+	assert(NULL != sched);
+	assert(NULL != specs || 0 == n);
+
+	if(0 == n)
+	{
+		return 0;
+	}
+
+	tasks = (void **)malloc(sizeof(void *) * n);
+	if(NULL == tasks)
+	{
+		return 1;
+	}
+
+	pthread_mutex_lock(&sched->lock);
+
+	if(NULL != sched->pool && 0 != FSAPoolReserve(sched->pool, n))
+	{
+		pthread_mutex_unlock(&sched->lock);
+		free(tasks);
+		return 1;
+	}
+
+	for(; idx < n; ++idx)
+	{
+		assert(NULL != specs[idx].action);
+
+		tasks[idx] = AllocTask(sched, specs[idx].first_execution_ns,
+		                       specs[idx].interval_ns, specs[idx].action,
+		                       specs[idx].params);
+		if(NULL == tasks[idx])
+		{
+			break;
+		}
+		IndexInsert(sched, (task_t *)tasks[idx]);
+	}
+
+	if(idx < n || 0 != QueueTasks(sched, tasks, n))
+	{
+		while(0 < idx)
+		{
+			--idx;
+			DestroyTask(sched, (task_t *)tasks[idx]);
+		}
+		status = 1;
+	}
+	else
+	{
+		for(idx = 0; NULL != out_uids && idx < n; ++idx)
+		{
+			out_uids[idx] = TaskGetUID((task_t *)tasks[idx]);
+		}
+		pthread_cond_broadcast(&sched->wakeup);
+	}
+
+	pthread_mutex_unlock(&sched->lock);
+	free(tasks);
+
+	return status;
 }
 
 /*******************************************************************************
@@ -106,20 +411,48 @@ void SchedRemoveTask(sched_t *sched, ilrd_uid_t task_id)
 {
 	task_t *task_to_destroy = NULL;
 	assert(NULL != sched);
-	if(NULL != sched->current_task && IsUIDMatch(&task_id, sched->current_task))
+	
+	pthread_mutex_lock(&sched->lock);
+
+	task_to_destroy = IndexFind(sched, task_id);
+	if(NULL == task_to_destroy)
 	{
-		TaskDestroy(sched->current_task);
-		sched->current_task = NULL;
+		pthread_mutex_unlock(&sched->lock);
+		return;
+	}
+	
+	if(IsPending(sched, task_to_destroy))
+	{
+		EraseTask(sched, task_to_destroy);
+		DestroyTask(sched, task_to_destroy);
 	}
 	else
 	{
-		task_to_destroy = (task_t *)PQErase(sched->pq, &IsUIDMatch , &task_id);
-	 		if(task_to_destroy != NULL)
-	 		{
-				TaskDestroy(task_to_destroy);
-				task_to_destroy = NULL;
-			}
+		if(task_to_destroy == sched->current_task)
+		{
+			sched->current_task = NULL;
+		}
+		else
+		{
+			--sched->in_flight;
+		}
+
+		/* not started yet - free it now, otherwise it is being executed
+		   and is freed by its runner when the action returns */
+		if(RemoveFromWorkers(sched, task_to_destroy))
+		{
+			DestroyTask(sched, task_to_destroy);
+		}
+		else
+		{
+			IndexRemove(sched, task_id);
+		}
+		pthread_cond_broadcast(&sched->wakeup);
 	}
+	
+	task_to_destroy = NULL;
+
+	pthread_mutex_unlock(&sched->lock);
 }
 
 /*******************************************************************************
@@ -127,9 +460,17 @@ void SchedRemoveTask(sched_t *sched, ilrd_uid_t task_id)
 *******************************************************************************/
 size_t SchedSize(const sched_t *sched)
 {
+	size_t size = 0;
+	pthread_mutex_t *lock = (pthread_mutex_t *)&sched->lock;
+
 	assert(NULL != sched);
 	
-	return PQSize(sched->pq) + (sched->current_task != NULL);
+	pthread_mutex_lock(lock);
+	size = PendingSize(sched) + (sched->current_task != NULL) +
+	       sched->in_flight;
+	pthread_mutex_unlock(lock);
+
+	return size;
 }
 
 /*******************************************************************************
@@ -139,7 +480,7 @@ int SchedIsEmpty(const sched_t *sched)
 {
 	assert(NULL != sched);
 	
-	return (PQIsEmpty(sched->pq)) && (sched->current_task == NULL);
+	return (0 == SchedSize(sched));
 }
 
 /*******************************************************************************
@@ -148,18 +489,24 @@ int SchedIsEmpty(const sched_t *sched)
 void SchedClear(sched_t *sched)
 {
 	assert(NULL != sched);
+
+	pthread_mutex_lock(&sched->lock);
 	
 	if(NULL != sched->current_task)
 	{
-		TaskDestroy(sched->current_task);
+		ilrd_uid_t uid = TaskGetUID(sched->current_task);
+
+		IndexRemove(sched, uid);
 		sched->current_task = NULL;
 	}
 	
-	while(!SchedIsEmpty(sched))
-	{
-		TaskDestroy((task_t *)PQDequeue(sched->pq));
-	}
-	
+	ClearPending(sched);
+
+	ClearWorkers(sched);
+	sched->in_flight = 0;
+	pthread_cond_broadcast(&sched->wakeup);
+
+	pthread_mutex_unlock(&sched->lock);
 }
 
 /*******************************************************************************
@@ -171,41 +518,194 @@ int SchedRun(sched_t *sched)
 	
 	assert(NULL != sched);
 	
+	pthread_mutex_lock(&sched->lock);
+
 	sched->is_running = 1;
 	
-	while(!SchedIsEmpty(sched) && sched->is_running)
+	while(0 != PendingSize(sched) && sched->is_running)
 	{
 		int task_run_res = 0;
+		task_t *task = NULL;
+		done_task_t done;
 		
-		SleepTillNextExec(sched);
+		if(WaitTillNextExec(sched))
+		{
+			continue;
+		}
 		
-		sched->current_task = (task_t *)PQDequeue(sched->pq);
+		task = PopDueTask(sched);
+		if(NULL == task)
+		{
+			continue;
+		}
+		sched->current_task = task;
+		done.is_timed = sched->is_stats_enabled;
+
+		pthread_mutex_unlock(&sched->lock);
+
+		/* the wheel expires a whole tick at once */
+		SleepUntil(TaskGetNextExecution(task));
+		task_run_res = RunTask(task, &done);
 	
-		task_run_res = TaskRun(sched->current_task);
-		if(NULL == sched->current_task)
+		pthread_mutex_lock(&sched->lock);
+
+		sched->current_task = NULL;
+		RecordRun(sched, &done);
+		if(!IsIndexed(sched, task))
 		{
+			FreeTask(sched, task);
 			continue;
 		}
 		
 		if(0 == task_run_res)
 		{
-			sched_res = SetNextExecutionOfTask(sched);	
+			sched_res = RescheduleTask(sched, task);
+			if(0 != sched_res)
+			{
+				sched->is_running = 0;
+			}
 		}
 		
 		else
 		{
-			TaskDestroy(sched->current_task);	
+			DestroyTask(sched, task);
 		}
-		
-		sched->current_task = NULL;
 	}
 
 	sched->is_running = 0;
 
+	pthread_mutex_unlock(&sched->lock);
+
 	return sched_res;
 
 }
 
+/*******************************************************************************
+                            SchedEnableStats
+*******************************************************************************/
+void SchedEnableStats(sched_t *sched, int is_enabled)
+{
+	assert(NULL != sched);
+
+	pthread_mutex_lock(&sched->lock);
+	/* workers read the flag without the lock */
+	__atomic_store_n(&sched->is_stats_enabled, (0 != is_enabled),
+	                 __ATOMIC_RELAXED);
+	if(is_enabled)
+	{
+		UpdateHighWater(sched);
+	}
+	pthread_mutex_unlock(&sched->lock);
+}
+
+/*******************************************************************************
+                            SchedGetStats
+*******************************************************************************/
+void SchedGetStats(const sched_t *sched, sched_stats_t *stats)
+{
+	pthread_mutex_t *lock = (pthread_mutex_t *)&sched->lock;
+
+	assert(NULL != sched);
+	assert(NULL != stats);
+
+	pthread_mutex_lock(lock);
+	*stats = sched->stats;
+	pthread_mutex_unlock(lock);
+}
+
+/*******************************************************************************
+                            SchedGetTaskStats
+*******************************************************************************/
+int SchedGetTaskStats(const sched_t *sched, ilrd_uid_t task_id,
+                      sched_task_stats_t *stats)
+{
+	pthread_mutex_t *lock = (pthread_mutex_t *)&sched->lock;
+	const task_t *task = NULL;
+
+	assert(NULL != sched);
+	assert(NULL != stats);
+
+	pthread_mutex_lock(lock);
+
+	task = IndexFind(sched, task_id);
+	if(NULL != task)
+	{
+		const task_stats_t *task_stats = TaskGetStats(task);
+
+		stats->executions = task_stats->executions;
+		stats->failures = task_stats->failures;
+		stats->run_time_total_ns = task_stats->run_time_total;
+		stats->run_time_max_ns = task_stats->run_time_max;
+		stats->lateness_max_ns = task_stats->lateness_max;
+	}
+
+	pthread_mutex_unlock(lock);
+
+	return (NULL == task);
+}
+
+/*******************************************************************************
+                            SchedRunParallel
+*******************************************************************************/
+int SchedRunParallel(sched_t *sched, size_t n_workers)
+{
+	size_t idx = 0;
+	int sched_res = 0;
+
+	assert(NULL != sched);
+	assert(0 < n_workers);
+
+	pthread_mutex_lock(&sched->lock);
+
+	sched->is_running = 1;
+	sched->run_status = 0;
+
+	if(0 != CreateWorkers(sched, n_workers))
+	{
+		pthread_mutex_unlock(&sched->lock);
+		return 1;
+	}
+
+	/* dispatcher: hand every due task to the workers */
+	while(sched->is_running &&
+	      (0 != PendingSize(sched) || 0 != sched->in_flight))
+	{
+		if(0 == PendingSize(sched))
+		{
+			/* only periodic tasks that are being executed are left */
+			pthread_cond_wait(&sched->wakeup, &sched->lock);
+			continue;
+		}
+
+		if(WaitTillNextExec(sched))
+		{
+			continue;
+		}
+
+		Dispatch(sched);
+	}
+
+	sched->is_running = 0;
+	StopWorkers(sched);
+
+	pthread_mutex_unlock(&sched->lock);
+
+	for(idx = 0; idx < sched->n_workers; ++idx)
+	{
+		pthread_join(sched->workers[idx].thread, NULL);
+	}
+
+	pthread_mutex_lock(&sched->lock);
+
+	ReturnWorkerTasks(sched);
+	DestroyWorkers(sched);
+	sched_res = sched->run_status;
+
+	pthread_mutex_unlock(&sched->lock);
+
+	return sched_res;
+}
+
 /*******************************************************************************
                             SchedStop                             
 *******************************************************************************/
@@ -213,7 +713,25 @@ void SchedStop(sched_t *sched)
 {
 	assert(NULL != sched);
 	
+	pthread_mutex_lock(&sched->lock);
+
 	((sched_t *)sched)->is_running = 0;
+	pthread_cond_broadcast(&sched->wakeup);
+	pthread_cond_broadcast(&sched->work_ready);
+
+	pthread_mutex_unlock(&sched->lock);
+}
+
+/*******************************************************************************
+                            SchedTimeNs                             
+*******************************************************************************/
+unsigned long SchedTimeNs(void)
+{
+	struct timespec now;
+	
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	
+	return (unsigned long)now.tv_sec * NS_PER_SEC + (unsigned long)now.tv_nsec;
 }
 
 
@@ -222,13 +740,13 @@ static int FrequencyCmp(const void *new_task, const void *existing_task)
 	assert(NULL != new_task);
 	assert(NULL != existing_task);
 
-	if((TaskGetFirstExecution((task_t *)new_task)) < (TaskGetFirstExecution((task_t *)existing_task)))
+	if((TaskGetNextExecution((task_t *)new_task)) < (TaskGetNextExecution((task_t *)existing_task)))
 	{
 		return 1;
 
 	}
 	
-	if((TaskGetFirstExecution((task_t *)new_task)) > (TaskGetFirstExecution((task_t *)existing_task)))
+	if((TaskGetNextExecution((task_t *)new_task)) > (TaskGetNextExecution((task_t *)existing_task)))
 	{
 		return -1;
 
@@ -238,39 +756,855 @@ static int FrequencyCmp(const void *new_task, const void *existing_task)
 	
 }
 
-static int IsUIDMatch(const void *data, const void *params)
+/* the index holds tasks and is searched with either a task or an
+   ilrd_uid_t key, both start with the uid (see task.h) */
+/* wakeup is waited on with absolute CLOCK_MONOTONIC deadlines */
+static int InitSync(sched_t *sched)
 {
-	assert(NULL != data);
-	assert(NULL != params);
-	
-	return UIDIsSame(*(ilrd_uid_t *)data, TaskGetUID((task_t *)params));
+	pthread_condattr_t attr;
+
+	if(0 != pthread_mutex_init(&sched->lock, NULL))
+	{
+		return 1;
+	}
+
+	if(0 != pthread_condattr_init(&attr))
+	{
+		pthread_mutex_destroy(&sched->lock);
+		return 1;
+	}
+
+	if(0 != pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) ||
+	   0 != pthread_cond_init(&sched->wakeup, &attr))
+	{
+		pthread_condattr_destroy(&attr);
+		pthread_mutex_destroy(&sched->lock);
+		return 1;
+	}
+	pthread_condattr_destroy(&attr);
+
+	if(0 != pthread_cond_init(&sched->work_ready, NULL))
+	{
+		pthread_cond_destroy(&sched->wakeup);
+		pthread_mutex_destroy(&sched->lock);
+		return 1;
+	}
+
+	return 0;
 }
 
-static void SleepTillNextExec(sched_t *sched)
+/* a task block holds the task followed by its timing wheel timer, the
+   node that links it into a worker deque and its uid index link, so adding
+   a task to either engine or handing it to a worker needs no other
+   allocation */
+static size_t TimerOffset(void)
 {
-		time_t curr_time = time(NULL);
-		time_t next_exec = TaskGetFirstExecution((task_t *)(PQPeek(sched->pq)));
-		while(next_exec > curr_time)
-		{
-			sleep(difftime(next_exec, curr_time));
-			curr_time = time(NULL);
-		}
+	return (TaskStructSize() + sizeof(void *) - 1) / sizeof(void *) *
+	       sizeof(void *);
 }
 
-static int SetNextExecutionOfTask(sched_t *sched)
+static size_t NodeOffset(sched_engine_t engine)
 {
-			int enqueue_res = 0;
-			TaskSetNextExecution(sched->current_task,
-								 TaskGetFrequencyInSec(sched->current_task));
-			enqueue_res = PQEnqueue(sched->pq, sched->current_task);
+	if(SCHED_ENGINE_WHEEL == engine)
+	{
+		return TimerOffset() + (TimingWheelTimerSize() + sizeof(void *) - 1) /
+		       sizeof(void *) * sizeof(void *);
+	}
 
-			if(enqueue_res)
-			{
-				TaskDestroy(sched->current_task);
-				sched->is_running = 0;
-				 return 1;
-			}
-			
-			return 0;	
+	return TimerOffset();
+}
+
+static size_t IndexOffset(sched_engine_t engine)
+{
+	return NodeOffset(engine) + (sizeof(dlist_node_t) + sizeof(void *) - 1) /
+	       sizeof(void *) * sizeof(void *);
 }
 
+static size_t TaskBlockSize(sched_engine_t engine)
+{
+	return IndexOffset(engine) + sizeof(task_t *);
+}
+
+static int InitIndex(sched_t *sched, size_t n_tasks)
+{
+	size_t n_buckets = SCHED_INDEX_SIZE;
+
+	while(n_buckets < n_tasks)
+	{
+		n_buckets *= 2;
+	}
+
+	sched->uid_index = (task_t **)calloc(n_buckets, sizeof(task_t *));
+	sched->index_mask = n_buckets - 1;
+	sched->index_count = 0;
+
+	return (NULL == sched->uid_index);
+}
+
+static task_t **IndexLink(const sched_t *sched, task_t *task)
+{
+	return (task_t **)((char *)task + IndexOffset(sched->engine));
+}
+
+static task_t **IndexBucket(task_t **buckets, size_t mask, ilrd_uid_t uid)
+{
+	return buckets + (uid.number_id & mask);
+}
+
+/* never fails, without memory to grow the chains just get longer */
+static void IndexInsert(sched_t *sched, task_t *task)
+{
+	task_t **bucket = NULL;
+
+	if(sched->index_count + 1 > sched->index_mask + 1)
+	{
+		IndexGrow(sched);
+	}
+
+	bucket = IndexBucket(sched->uid_index, sched->index_mask,
+	                     TaskGetUID(task));
+	*IndexLink(sched, task) = *bucket;
+	*bucket = task;
+	++sched->index_count;
+}
+
+static task_t *IndexFind(const sched_t *sched, ilrd_uid_t uid)
+{
+	task_t *task = *IndexBucket(sched->uid_index, sched->index_mask, uid);
+
+	while(NULL != task && !UIDIsSame(TaskGetUID(task), uid))
+	{
+		task = *IndexLink(sched, task);
+	}
+
+	return task;
+}
+
+static void IndexRemove(sched_t *sched, ilrd_uid_t uid)
+{
+	task_t **link = IndexBucket(sched->uid_index, sched->index_mask, uid);
+
+	while(NULL != *link && !UIDIsSame(TaskGetUID(*link), uid))
+	{
+		link = IndexLink(sched, *link);
+	}
+
+	if(NULL != *link)
+	{
+		*link = *IndexLink(sched, *link);
+		--sched->index_count;
+	}
+}
+
+/* doubles the buckets, the tasks are relinked in place */
+static void IndexGrow(sched_t *sched)
+{
+	size_t new_mask = sched->index_mask * 2 + 1;
+	task_t **buckets = (task_t **)calloc(new_mask + 1, sizeof(task_t *));
+	size_t idx = 0;
+
+	if(NULL == buckets)
+	{
+		return;
+	}
+
+	for(; idx <= sched->index_mask; ++idx)
+	{
+		task_t *task = sched->uid_index[idx];
+
+		while(NULL != task)
+		{
+			task_t *next = *IndexLink(sched, task);
+			task_t **bucket = IndexBucket(buckets, new_mask, TaskGetUID(task));
+
+			*IndexLink(sched, task) = *bucket;
+			*bucket = task;
+			task = next;
+		}
+	}
+
+	free(sched->uid_index);
+	sched->uid_index = buckets;
+	sched->index_mask = new_mask;
+}
+
+static task_t *AllocTask(sched_t *sched, unsigned long first_execution,
+                         unsigned long interval, int(*action)(void *params),
+                         void *params)
+{
+	void *block = (NULL != sched->pool) ? FSAPoolAlloc(sched->pool) :
+	              malloc(TaskBlockSize(sched->engine));
+	task_t *task = NULL;
+
+	if(NULL == block)
+	{
+		return NULL;
+	}
+
+	task = TaskInit(block, first_execution, interval, action, params);
+	if(NULL == task)
+	{
+		FreeTask(sched, (task_t *)block);
+	}
+
+	return task;
+}
+
+static void FreeTask(sched_t *sched, task_t *task)
+{
+	if(NULL != sched->pool)
+	{
+		FSAPoolFree(sched->pool, task);
+	}
+	else
+	{
+		free(task);
+	}
+}
+
+static void DestroyTask(sched_t *sched, task_t *task)
+{
+	ilrd_uid_t uid = TaskGetUID(task);
+	
+	IndexRemove(sched, uid);
+	FreeTask(sched, task);
+}
+
+static void DestroyTaskAction(void *task, void *sched)
+{
+	DestroyTask((sched_t *)sched, (task_t *)task);
+}
+
+static int IsIndexed(const sched_t *sched, const task_t *task)
+{
+	ilrd_uid_t uid = TaskGetUID(task);
+
+	return (IndexFind(sched, uid) == task);
+}
+
+static int IsPending(const sched_t *sched, const task_t *task)
+{
+	if(SCHED_ENGINE_WHEEL == sched->engine)
+	{
+		return (NULL != TaskGetSchedHandle(task));
+	}
+
+	return (PQ_NO_INDEX != TaskGetPQIndex(task));
+}
+
+static int QueueTask(sched_t *sched, task_t *task)
+{
+	if(SCHED_ENGINE_PQ == sched->engine)
+	{
+		if(0 != PQEnqueue(sched->pq, task))
+		{
+			return 1;
+		}
+	}
+	else
+	{
+		TaskSetSchedHandle(task, TimingWheelAddAt(sched->wheel,
+		                   (char *)task + TimerOffset(), task,
+		                   TaskGetNextExecution(task) / NS_PER_TICK));
+	}
+	
+	if(sched->is_stats_enabled)
+	{
+		UpdateHighWater(sched);
+	}
+	
+	return 0;
+}
+
+static int QueueTasks(sched_t *sched, void *const *tasks, size_t n)
+{
+	size_t idx = 0;
+
+	if(SCHED_ENGINE_PQ != sched->engine)
+	{
+		for(; idx < n; ++idx)
+		{
+			QueueTask(sched, (task_t *)tasks[idx]);
+		}
+	}
+	else if(0 != PQEnqueueMany(sched->pq, tasks, n))
+	{
+		return 1;
+	}
+	else if(sched->is_stats_enabled)
+	{
+		UpdateHighWater(sched);
+	}
+	
+	return 0;
+}
+
+static void EraseTask(sched_t *sched, task_t *task)
+{
+	if(SCHED_ENGINE_WHEEL == sched->engine)
+	{
+		TimingWheelRemove(sched->wheel, TaskGetSchedHandle(task));
+		TaskSetSchedHandle(task, NULL);
+	}
+	else
+	{
+		PQEraseAt(sched->pq, TaskGetPQIndex(task));
+	}
+}
+
+/* the wheel may wake up before anything is due (see TimingWheelNextExpiry),
+   in that case NULL is returned and the caller goes back to sleep */
+static task_t *PopDueTask(sched_t *sched)
+{
+	task_t *task = NULL;
+	
+	if(SCHED_ENGINE_PQ == sched->engine)
+	{
+		return (task_t *)PQDequeue(sched->pq);
+	}
+	
+	task = (task_t *)TimingWheelPopExpired(sched->wheel,
+	                                       SchedTimeNs() / NS_PER_TICK);
+	if(NULL != task)
+	{
+		TaskSetSchedHandle(task, NULL);
+	}
+	
+	return task;
+}
+
+static size_t PendingSize(const sched_t *sched)
+{
+	if(SCHED_ENGINE_WHEEL == sched->engine)
+	{
+		return TimingWheelSize(sched->wheel);
+	}
+	
+	return PQSize(sched->pq);
+}
+
+static void ClearPending(sched_t *sched)
+{
+	if(SCHED_ENGINE_WHEEL == sched->engine)
+	{
+		TimingWheelClear(sched->wheel, DestroyTaskAction, sched);
+		return;
+	}
+		
+	while(!PQIsEmpty(sched->pq))
+	{
+		DestroyTask(sched, (task_t *)PQDequeue(sched->pq));
+	}
+}
+
+/* called with the lock held, returns non-zero if it had to wait - the caller
+   has to look again, a task may have been added or the run stopped */
+static int WaitTillNextExec(sched_t *sched)
+{
+	struct timespec deadline;
+	unsigned long next_exec = (SCHED_ENGINE_WHEEL == sched->engine) ?
+	             TimingWheelNextExpiry(sched->wheel) * NS_PER_TICK :
+	             TaskGetNextExecution((task_t *)(PQPeek(sched->pq)));
+
+	if(next_exec <= SchedTimeNs())
+	{
+		return 0;
+	}
+
+	ToTimespec(next_exec, &deadline);
+	pthread_cond_timedwait(&sched->wakeup, &sched->lock, &deadline);
+
+	return 1;
+}
+
+/* absolute deadline, so a signal or a late wakeup does not add up */
+static void SleepUntil(unsigned long deadline)
+{
+	struct timespec wakeup;
+	
+	ToTimespec(deadline, &wakeup);
+	
+	while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup,
+	                               NULL))
+	{
+	}
+}
+
+static void ToTimespec(unsigned long ns, struct timespec *ts)
+{
+	ts->tv_sec = (time_t)(ns / NS_PER_SEC);
+	ts->tv_nsec = (long)(ns % NS_PER_SEC);
+}
+
+/* reads the clock only when the run is timed */
+static int RunTask(task_t *task, done_task_t *done)
+{
+	unsigned long planned = TaskGetNextExecution(task);
+	unsigned long start = 0;
+
+	done->task = task;
+	done->lateness = 0;
+	done->run_time = 0;
+	if(!done->is_timed)
+	{
+		done->task_run_res = TaskRun(task);
+		return done->task_run_res;
+	}
+
+	start = SchedTimeNs();
+	done->task_run_res = TaskRun(task);
+	done->run_time = SchedTimeNs() - start;
+	done->lateness = (start > planned) ? start - planned : 0;
+
+	return done->task_run_res;
+}
+
+/* called with the sched lock held. Lateness bucket 0 is below one
+   microsecond, bucket i holds [2^(i-1), 2^i) microseconds */
+static void RecordRun(sched_t *sched, const done_task_t *done)
+{
+	sched_stats_t *stats = &sched->stats;
+	unsigned long lateness_us = done->lateness / NS_PER_USEC;
+	size_t bucket = 0;
+	int is_failed = (0 > done->task_run_res);
+
+	if(!done->is_timed)
+	{
+		return;
+	}
+
+	++stats->executions;
+	stats->failures += is_failed;
+	stats->run_time_total_ns += done->run_time;
+	if(done->run_time > stats->run_time_max_ns)
+	{
+		stats->run_time_max_ns = done->run_time;
+	}
+
+	for(; 0 != lateness_us && bucket < SCHED_LATENESS_BUCKETS - 1; ++bucket)
+	{
+		lateness_us >>= 1;
+	}
+	++stats->lateness_hist[bucket];
+
+	TaskAddRun(done->task, done->lateness, done->run_time, is_failed);
+}
+
+static void UpdateHighWater(sched_t *sched)
+{
+	size_t size = PendingSize(sched);
+
+	if(size > sched->stats.queue_high_water)
+	{
+		sched->stats.queue_high_water = size;
+	}
+}
+
+static int RescheduleTask(sched_t *sched, task_t *task)
+{
+	TaskSetNextExecution(task, SchedTimeNs());
+
+	if(0 != QueueTask(sched, task))
+	{
+		DestroyTask(sched, task);
+		return 1;
+	}
+
+	return 0;
+}
+
+/* threads are started last, a failure leaves no worker behind */
+static int CreateWorkers(sched_t *sched, size_t n_workers)
+{
+	size_t idx = 0;
+
+	sched->workers = (worker_t *)malloc(sizeof(worker_t) * n_workers);
+	if(NULL == sched->workers)
+	{
+		return 1;
+	}
+
+	for(sched->n_workers = 0; sched->n_workers < n_workers; ++sched->n_workers)
+	{
+		worker_t *worker = &sched->workers[sched->n_workers];
+
+		worker->sched = sched;
+		worker->task = NULL;
+		worker->n_done = 0;
+		worker->is_stopped = 0;
+		worker->deque = DListCreateIntrusive();
+		if(NULL == worker->deque)
+		{
+			break;
+		}
+		if(0 != pthread_mutex_init(&worker->lock, NULL))
+		{
+			DListDestroy(worker->deque);
+			break;
+		}
+	}
+
+	for(idx = 0; idx < sched->n_workers && sched->n_workers == n_workers; ++idx)
+	{
+		if(0 != pthread_create(&sched->workers[idx].thread, NULL,
+		                       WorkerRoutine, &sched->workers[idx]))
+		{
+			break;
+		}
+	}
+
+	if(idx == n_workers)
+	{
+		return 0;
+	}
+
+	sched->is_running = 0;
+	StopWorkers(sched);
+	pthread_mutex_unlock(&sched->lock);
+	for(; 0 < idx; --idx)
+	{
+		pthread_join(sched->workers[idx - 1].thread, NULL);
+	}
+	pthread_mutex_lock(&sched->lock);
+
+	DestroyWorkers(sched);
+
+	return 1;
+}
+
+static void DestroyWorkers(sched_t *sched)
+{
+	size_t idx = 0;
+
+	for(; idx < sched->n_workers; ++idx)
+	{
+		pthread_mutex_destroy(&sched->workers[idx].lock);
+		DListDestroy(sched->workers[idx].deque);
+	}
+
+	free(sched->workers); sched->workers = NULL;
+	sched->n_workers = 0;
+}
+
+static int IsSameTask(const void *task1, const void *task2)
+{
+	return (task1 == task2);
+}
+
+/* O(in_flight), tasks are not expected to be removed often while they
+   are waiting in a deque */
+static int RemoveFromWorkers(sched_t *sched, task_t *task)
+{
+	size_t idx = 0;
+	int is_found = 0;
+
+	for(; idx < sched->n_workers && !is_found; ++idx)
+	{
+		worker_t *worker = &sched->workers[idx];
+		dlist_iter_t end = DListEnd(worker->deque);
+		dlist_iter_t where = end;
+
+		pthread_mutex_lock(&worker->lock);
+		end = DListEnd(worker->deque);
+		where = DListFind(DListBegin(worker->deque), end, IsSameTask, task);
+		if(!DListIsSameIter(where, end))
+		{
+			DListRemove(worker->deque, where);
+			is_found = 1;
+		}
+		pthread_mutex_unlock(&worker->lock);
+	}
+
+	return is_found;
+}
+
+/* tasks that are executed or done are only taken out of the index, their
+   worker frees them when it returns them */
+static void ClearWorkers(sched_t *sched)
+{
+	size_t idx = 0;
+
+	for(; idx < sched->n_workers; ++idx)
+	{
+		worker_t *worker = &sched->workers[idx];
+		size_t done_idx = 0;
+
+		pthread_mutex_lock(&worker->lock);
+
+		while(!DListIsEmpty(worker->deque))
+		{
+			task_t *task = (task_t *)DListGetData(DListBegin(worker->deque));
+
+			DListRemove(worker->deque, DListBegin(worker->deque));
+			DestroyTask(sched, task);
+		}
+
+		if(NULL != worker->task && IsIndexed(sched, worker->task))
+		{
+			ilrd_uid_t uid = TaskGetUID(worker->task);
+
+			IndexRemove(sched, uid);
+		}
+
+		for(; done_idx < worker->n_done; ++done_idx)
+		{
+			if(IsIndexed(sched, worker->done[done_idx].task))
+			{
+				ilrd_uid_t uid = TaskGetUID(worker->done[done_idx].task);
+
+				IndexRemove(sched, uid);
+			}
+		}
+
+		pthread_mutex_unlock(&worker->lock);
+	}
+}
+
+static int IsDue(const sched_t *sched, unsigned long now)
+{
+	if(SCHED_ENGINE_WHEEL == sched->engine)
+	{
+		return (0 != TimingWheelSize(sched->wheel) &&
+		        TimingWheelNextExpiry(sched->wheel) * NS_PER_TICK <= now);
+	}
+
+	return (!PQIsEmpty(sched->pq) &&
+	        TaskGetNextExecution((task_t *)PQPeek(sched->pq)) <= now);
+}
+
+/* hands all due tasks (up to DISPATCH_BATCH) round robin to the worker
+   deques, then wakes the workers once */
+static void Dispatch(sched_t *sched)
+{
+	unsigned long now = SchedTimeNs();
+	size_t count = 0;
+
+	while(count < DISPATCH_BATCH && IsDue(sched, now))
+	{
+		worker_t *worker = NULL;
+		task_t *task = PopDueTask(sched);
+
+		if(NULL == task)
+		{
+			break;
+		}
+
+		worker = &sched->workers[(sched->dispatched + count) %
+		                         sched->n_workers];
+
+		pthread_mutex_lock(&worker->lock);
+		DListPushBackNode(worker->deque, (dlist_node_t *)((char *)task +
+		                  NodeOffset(sched->engine)), task);
+		pthread_mutex_unlock(&worker->lock);
+
+		++sched->in_flight;
+		++count;
+	}
+
+	sched->dispatched += count;
+	pthread_cond_broadcast(&sched->work_ready);
+}
+
+/* workers finish the task they execute and take no new one */
+static void StopWorkers(sched_t *sched)
+{
+	size_t idx = 0;
+
+	for(; idx < sched->n_workers; ++idx)
+	{
+		pthread_mutex_lock(&sched->workers[idx].lock);
+		sched->workers[idx].is_stopped = 1;
+		pthread_mutex_unlock(&sched->workers[idx].lock);
+	}
+
+	pthread_cond_broadcast(&sched->work_ready);
+}
+
+static task_t *TakeTask(worker_t *self)
+{
+	task_t *task = NULL;
+
+	pthread_mutex_lock(&self->lock);
+
+	if(!self->is_stopped && !DListIsEmpty(self->deque))
+	{
+		task = (task_t *)DListGetData(DListBegin(self->deque));
+		DListRemove(self->deque, DListBegin(self->deque));
+		self->task = task;
+	}
+
+	pthread_mutex_unlock(&self->lock);
+
+	return task;
+}
+
+/* both worker locks are held while the task moves, so it is always visible
+   to SchedRemoveTask / SchedClear */
+static task_t *StealTask(worker_t *self)
+{
+	sched_t *sched = self->sched;
+	size_t self_idx = self - sched->workers;
+	size_t step = 1;
+	task_t *task = NULL;
+
+	for(; step < sched->n_workers && NULL == task; ++step)
+	{
+		worker_t *victim = &sched->workers[(self_idx + step) % sched->n_workers];
+		worker_t *first = (victim < self) ? victim : self;
+		worker_t *second = (victim < self) ? self : victim;
+
+		pthread_mutex_lock(&first->lock);
+		pthread_mutex_lock(&second->lock);
+
+		if(!self->is_stopped && !DListIsEmpty(victim->deque))
+		{
+			task = (task_t *)DListGetData(DListPrevIter(DListEnd(victim->deque)));
+			DListPopBack(victim->deque);
+			self->task = task;
+		}
+
+		pthread_mutex_unlock(&second->lock);
+		pthread_mutex_unlock(&first->lock);
+	}
+
+	return task;
+}
+
+static size_t CompleteTask(worker_t *self, const done_task_t *done)
+{
+	size_t n_done = 0;
+
+	pthread_mutex_lock(&self->lock);
+
+	self->task = NULL;
+	self->done[self->n_done] = *done;
+	n_done = ++self->n_done;
+
+	pthread_mutex_unlock(&self->lock);
+
+	return n_done;
+}
+
+/* called with the sched lock held */
+static void FlushDone(sched_t *sched, worker_t *worker)
+{
+	done_task_t done[WORKER_BATCH];
+	size_t n_done = 0;
+	size_t idx = 0;
+
+	pthread_mutex_lock(&worker->lock);
+	for(; idx < worker->n_done; ++idx)
+	{
+		done[idx] = worker->done[idx];
+	}
+	n_done = worker->n_done;
+	worker->n_done = 0;
+	pthread_mutex_unlock(&worker->lock);
+
+	for(idx = 0; idx < n_done; ++idx)
+	{
+		task_t *task = done[idx].task;
+
+		RecordRun(sched, &done[idx]);
+		if(!IsIndexed(sched, task))
+		{
+			FreeTask(sched, task);
+			continue;
+		}
+
+		--sched->in_flight;
+		if(0 != done[idx].task_run_res)
+		{
+			DestroyTask(sched, task);
+		}
+		else if(0 != RescheduleTask(sched, task))
+		{
+			sched->run_status = 1;
+			sched->is_running = 0;
+		}
+	}
+
+	if(0 != n_done)
+	{
+		pthread_cond_broadcast(&sched->wakeup);
+	}
+}
+
+static void *WorkerRoutine(void *worker)
+{
+	worker_t *self = (worker_t *)worker;
+	sched_t *sched = self->sched;
+	size_t seen = 0;
+	int is_running = 1;
+
+	while(is_running)
+	{
+		task_t *task = TakeTask(self);
+
+		if(NULL == task)
+		{
+			task = StealTask(self);
+		}
+
+		if(NULL != task)
+		{
+			done_task_t done;
+
+			done.is_timed = __atomic_load_n(&sched->is_stats_enabled,
+			                                __ATOMIC_RELAXED);
+			SleepUntil(TaskGetNextExecution(task));
+			RunTask(task, &done);
+
+			if(WORKER_BATCH != CompleteTask(self, &done) &&
+			   0 != done.task_run_res)
+			{
+				continue;
+			}
+		}
+
+		pthread_mutex_lock(&sched->lock);
+
+		FlushDone(sched, self);
+
+		/* nothing to take or steal - wait for the next dispatch */
+		while(NULL == task && sched->is_running && seen == sched->dispatched)
+		{
+			pthread_cond_wait(&sched->work_ready, &sched->lock);
+		}
+		seen = sched->dispatched;
+		is_running = sched->is_running;
+
+		pthread_mutex_unlock(&sched->lock);
+	}
+
+	pthread_mutex_lock(&sched->lock);
+	FlushDone(sched, self);
+	pthread_mutex_unlock(&sched->lock);
+
+	return NULL;
+}
+
+/* tasks that were handed out but not started when the run stopped go back
+   to the pending engine, so a stopped sched can be run again */
+static void ReturnWorkerTasks(sched_t *sched)
+{
+	size_t idx = 0;
+
+	for(; idx < sched->n_workers; ++idx)
+	{
+		dlist_t *deque = sched->workers[idx].deque;
+
+		while(!DListIsEmpty(deque))
+		{
+			task_t *task = (task_t *)DListGetData(DListBegin(deque));
+
+			DListRemove(deque, DListBegin(deque));
+			--sched->in_flight;
+			if(0 != QueueTask(sched, task))
+			{
+				DestroyTask(sched, task);
+				sched->run_status = 1;
+			}
+		}
+	}
+}
@@ -18,22 +18,110 @@
  
 typedef struct scheduler sched_t;
 
+/* the structure that holds the pending tasks:
+ * SCHED_ENGINE_PQ - addressable binary heap ordered by execution time,
+ * O(log n) add / remove / expire.
+ * SCHED_ENGINE_WHEEL - hierarchical timing wheel with one millisecond ticks,
+ * O(1) add / remove / expire, suited for very large numbers of tasks. */
+typedef enum sched_engine
+{
+	SCHED_ENGINE_PQ = 0,
+	SCHED_ENGINE_WHEEL
+} sched_engine_t;
+
+/* one task for SchedAddTasks, same meaning as the SchedAddTaskNs params */
+typedef struct task_spec
+{
+	unsigned long first_execution_ns;
+	unsigned long interval_ns;
+	int (*action)(void *params);
+	void *params;
+} task_spec_t;
+
+/* number of buckets of the lateness histogram, see SchedGetStats */
+#define SCHED_LATENESS_BUCKETS (32)
+
+/* statistics of all runs while stats were enabled, times in nanoseconds */
+typedef struct sched_stats
+{
+	size_t executions;
+	size_t failures;
+	unsigned long run_time_total_ns;
+	unsigned long run_time_max_ns;
+	size_t lateness_hist[SCHED_LATENESS_BUCKETS];
+	size_t queue_high_water;
+} sched_stats_t;
+
+/* statistics of the runs of one task while stats were enabled */
+typedef struct sched_task_stats
+{
+	size_t executions;
+	size_t failures;
+	unsigned long run_time_total_ns;
+	unsigned long run_time_max_ns;
+	unsigned long lateness_max_ns;
+} sched_task_stats_t;
+
  
 /* in c file
 
 #include "pq.h"
 #include "sched.h"
 #include "task.h"
+#include "timing_wheel.h"
+#include "doubly_linked_list.h"
+#include "fsa.h"
+
+typedef struct done_task
+{
+	task_t *task;
+	int task_run_res;
+	int is_timed;
+	unsigned long lateness;
+	unsigned long run_time;
+} done_task_t;
+
+typedef struct worker
+{
+	pthread_t thread;
+	sched_t *sched;
+	pthread_mutex_t lock;
+	dlist_t *deque;
+	task_t *task;
+	done_task_t done[WORKER_BATCH];
+	size_t n_done;
+	int is_stopped;
+} worker_t;
 
 struct scheduler
 {
+	sched_engine_t engine;
 	pq_t *pq;
+	timing_wheel_t *wheel;
+	task_t **uid_index;
+	size_t index_mask;
+	size_t index_count;
 	task_t *current_task;
 	int is_running;
+	int run_status;
+	pthread_mutex_t lock;
+	pthread_cond_t wakeup;
+	pthread_cond_t work_ready;
+	worker_t *workers;
+	size_t n_workers;
+	size_t in_flight;
+	size_t dispatched;
+	fsa_pool_t *pool;
+	int is_stats_enabled;
+	sched_stats_t stats;
 };
 
 */
 
+/* All functions except SchedCreate / SchedDestroy are thread safe: tasks can
+ * be added, removed and the sched stopped from any thread, including from
+ * inside a task action, while SchedRun or SchedRunParallel is running. */
+
 /* DESCRIPTION:
  * A function that creates a new scheduler.
  * Memory will be specially allocated.
@@ -50,6 +138,46 @@ struct scheduler
  
 sched_t *SchedCreate(void);
 /*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * A function that creates a new scheduler that keeps its tasks in the given
+ * engine. SchedCreate() is SchedCreateEngine(SCHED_ENGINE_PQ).
+ * All other sched functions behave the same with both engines.
+ *
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ * sched_engine_t engine - SCHED_ENGINE_PQ or SCHED_ENGINE_WHEEL
+ *
+ * RETURN VALUE:
+ * sched_t * - pointer to new created sched, NULL if memory
+ * allocation failed.
+ */ 
+ 
+sched_t *SchedCreateEngine(sched_engine_t engine);
+/*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * Same as SchedCreateEngine, the tasks are allocated from a pool of fixed
+ * size blocks instead of one malloc per task. The pool starts with room for
+ * initial_tasks tasks and grows by doubling, its memory is kept until
+ * SchedDestroy. With SCHED_ENGINE_WHEEL the timer of a task is placed in the
+ * same block, and so is the link of the uid index, which starts with room
+ * for initial_tasks tasks too: adding a task allocates nothing until there
+ * are more than initial_tasks tasks.
+ * SchedCreatePooled(engine, 0) is SchedCreateEngine(engine).
+ *
+ * Time complexity: O(initial_tasks)
+ *
+ * PARAMETERS:
+ * sched_engine_t engine - SCHED_ENGINE_PQ or SCHED_ENGINE_WHEEL
+ * size_t initial_tasks - number of tasks the pool has room for at start.
+ *
+ * RETURN VALUE:
+ * sched_t * - pointer to new created sched, NULL if memory
+ * allocation failed.
+ */ 
+ 
+sched_t *SchedCreatePooled(sched_engine_t engine, size_t initial_tasks);
+/*----------------------------------------------------------------------------*/
 /* DESCRIPTION:
  * A function that destroys a specified scheduler . 
  * Previously allocated memory will be freed.
@@ -73,8 +201,10 @@ void SchedDestroy(sched_t *sched);
  * A function that creates a new Sched element that holds  
  * specified task and adds it to the Sched considering its priority. 
  * Memory will be allocated for new Sched element.
+ * first_execution is a wall clock time, it is converted once to the
+ * monotonic clock the scheduler runs on (see SchedAddTaskNs).
  *
- * Time complexity: O(n) 
+ * Time complexity: O(log n), O(1) with SCHED_ENGINE_WHEEL 
  *
  * PARAMETERS:
  * sched_t *Sched -	pointer to Sched to be added to. 
@@ -92,10 +222,61 @@ void SchedDestroy(sched_t *sched);
 ilrd_uid_t SchedAddTask(sched_t *sched, time_t first_execution,
 		size_t frequency_in_sec, int(*action)(void *params), void *params);
 /*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * Same as SchedAddTask with nanosecond resolution.
+ * Times are on the monotonic clock returned by SchedTimeNs(), so changes of
+ * the wall clock do not affect the scheduler. A periodic task is rescheduled
+ * interval_ns after its previous planned execution (no drift), periods that
+ * were missed while a task was late are skipped.
+ *
+ * Time complexity: O(log n), O(1) with SCHED_ENGINE_WHEEL 
+ *
+ * PARAMETERS:
+ * sched_t *Sched -	pointer to Sched to be added to. 
+ * unsigned long first_execution_ns - first time to execute the task
+ * unsigned long interval_ns - time between executions
+ * *action - the function to preform return 0 if function should return
+ *   and 1 if not) 
+ * params - parameter for the action function 
+ *
+ *(In case of pointers pointing to invalid Sched or task, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * ilrd_uid_t - unique identifier of task on success, BAD_UID on failure.
+ */
+ilrd_uid_t SchedAddTaskNs(sched_t *sched, unsigned long first_execution_ns,
+		unsigned long interval_ns, int(*action)(void *params), void *params);
+/*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * A function that adds n tasks at once, for loading many tasks at startup.
+ * The pool of a SchedCreatePooled sched is grown once for the whole batch
+ * and with SCHED_ENGINE_PQ the queue is built in one pass instead of n
+ * separate inserts. Tasks with the same execution time run in the order of
+ * specs. Either all tasks are added or none.
+ *
+ * Time complexity: O(n + size) when n >= size, O(n log size) otherwise,
+ * O(n) with SCHED_ENGINE_WHEEL
+ *
+ * PARAMETERS:
+ * sched_t *Sched -	pointer to Sched to be added to. 
+ * const task_spec_t *specs - array of n task descriptions.
+ * size_t n - number of tasks.
+ * ilrd_uid_t *out_uids - array of n uids that receives the uid of each task,
+ *   may be NULL.
+ *
+ *(In case of pointers pointing to invalid Sched or specs, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if failed (no task was added).
+ */
+int SchedAddTasks(sched_t *sched, const task_spec_t *specs, size_t n,
+		ilrd_uid_t *out_uids);
+/*----------------------------------------------------------------------------*/
 /* DESCRIPTION:
  * A function that erase a specific task.
+ * The task is located through a UID index, the queue is not scanned.
  * 
- * Time complexity: O(n)
+ * Time complexity: O(log n), O(1) with SCHED_ENGINE_WHEEL
  *
  * PARAMETERS:
  * const sched_t *sched - pointer to a sched.
@@ -111,7 +292,7 @@ void SchedRemoveTask(sched_t *sched, ilrd_uid_t task_id);
 /* DESCRIPTION:
  * A function that returns current number of elements in a Sched. 
  *
- * Time complexity: O(n)
+ * Time complexity: O(1)
  *
  * PARAMETERS:
  * sched_t *Sched - pointer to a sched. 
@@ -168,6 +349,30 @@ void SchedClear(sched_t *sched);
  */
 int SchedRun(sched_t *sched);
 /*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * A function that runs the tasks on a pool of worker threads till the sched
+ * is empty or stoped by SchedStop().
+ * The calling thread becomes the dispatcher: it waits for the next due tasks
+ * and spreads them over the local deques of the workers, so a slow action
+ * does not delay other due tasks. A worker with an empty deque steals tasks
+ * from the others, workers only take the sched lock to return a batch of
+ * finished tasks. A periodic task is rescheduled when its action returns, so the same
+ * task is never executed by two workers at the same time.
+ * Tasks that were not started when the run stopped stay in the sched.
+ * 
+ * Time complexity: O(n)
+ *
+ * PARAMETERS:
+ *  sched_t *sched - pointer to a sched.
+ *  size_t n_workers - number of worker threads, at least one.
+ * 
+ * (In case of pointer pointing to invalid variable, behavior is undefined)
+ *
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if failed.
+ */
+int SchedRunParallel(sched_t *sched, size_t n_workers);
+/*----------------------------------------------------------------------------*/
 /* DESCRIPTION:
  * A function that stops the execution of scheduler tasks.
  * 
@@ -183,4 +388,69 @@ int SchedRun(sched_t *sched);
  */
 void SchedStop(sched_t *sched);
 /*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * A function that returns the current time of the scheduler clock
+ * (CLOCK_MONOTONIC) in nanoseconds, to be used with SchedAddTaskNs.
+ * 
+ * Time complexity: O(1)
+ *
+ * RETURN VALUE:
+ * unsigned long - current monotonic time in nanoseconds.
+ */
+unsigned long SchedTimeNs(void);
+/*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * A function that turns the run statistics on or off (off by default).
+ * While off, the only cost is one flag check per run. While on, the clock
+ * is read before and after every action and the counters are updated with
+ * the sched lock that is already taken after a run.
+ * An action that returns a negative value is counted as a failure (the task
+ * is removed, as for any non-zero value).
+ * Counters are kept when stats are turned off and on again.
+ * 
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ *  sched_t *sched - pointer to a sched.
+ *  int is_enabled - non-zero to turn the stats on, zero to turn them off.
+ * 
+ * RETURN VALUE:
+ * no return value.
+ */
+void SchedEnableStats(sched_t *sched, int is_enabled);
+/*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * A function that copies the statistics of all runs.
+ * lateness_hist counts runs by their lateness (start of the action minus
+ * its planned time): bucket 0 is below one microsecond, bucket i is
+ * [2^(i-1), 2^i) microseconds and the last bucket holds everything above.
+ * queue_high_water is the largest number of pending tasks seen.
+ * 
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ *  const sched_t *sched - pointer to a sched.
+ *  sched_stats_t *stats - receives the statistics.
+ * 
+ * RETURN VALUE:
+ * no return value.
+ */
+void SchedGetStats(const sched_t *sched, sched_stats_t *stats);
+/*----------------------------------------------------------------------------*/
+/* DESCRIPTION:
+ * A function that copies the statistics of a specific task.
+ * 
+ * Time complexity: O(1)
+ *
+ * PARAMETERS:
+ *  const sched_t *sched - pointer to a sched.
+ *  ilrd_uid_t task_id - the specific task id 
+ *  sched_task_stats_t *stats - receives the statistics.
+ * 
+ * RETURN VALUE:
+ * int - zero if succeeded, non-zero if there is no such task.
+ */
+int SchedGetTaskStats(const sched_t *sched, ilrd_uid_t task_id,
+		sched_task_stats_t *stats);
+/*----------------------------------------------------------------------------*/
 #endif /*__ILRD_OL95_SCHEDULER_H___*/
@@ -0,0 +1,123 @@
+/********************************************
+File name : sched_bench.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* SchedRunParallel throughput with 1, 2, 4 .. up to the number of online
+   cores workers, all the tasks are due in the same tick and every action
+   does about a microsecond of work.
+   make bench */
+
+#define _POSIX_C_SOURCE 200112L	/* sysconf */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <stdlib.h>	/* malloc, free */
+#include <unistd.h>	/* sysconf */
+
+#include "sched.h"	/* scheduler API */
+
+#define N_TASKS ((size_t)1 << 18)
+#define TASK_WORK (200)
+
+static int ShortTask(void *params)
+{
+	volatile size_t sum = 0;
+	size_t i = 0;
+
+	(void)params;
+	for(; i < TASK_WORK; ++i)
+	{
+		sum += i;
+	}
+
+	/* one shot */
+	return 1;
+}
+
+static void Bench(sched_engine_t engine, task_spec_t *specs,
+                  size_t n_workers, double *base)
+{
+	sched_t *sched = SchedCreatePooled(engine, N_TASKS);
+	unsigned long time = 0;
+	size_t idx = 0;
+	double rate = 0;
+
+	if(NULL == sched)
+	{
+		printf("sched creation failed\n");
+		return;
+	}
+
+	time = SchedTimeNs();
+	for(idx = 0; idx < N_TASKS; ++idx)
+	{
+		specs[idx].first_execution_ns = time;
+	}
+
+	if(0 != SchedAddTasks(sched, specs, N_TASKS, NULL))
+	{
+		printf("adding the tasks failed\n");
+		SchedDestroy(sched);
+		return;
+	}
+
+	time = SchedTimeNs();
+	SchedRunParallel(sched, n_workers);
+	time = SchedTimeNs() - time;
+
+	rate = N_TASKS / (time * 1e-9);
+	*base = (0 == *base) ? rate : *base;
+	printf("%-5s %3lu workers: %8.2f M tasks/s, %5.2fx one worker%s\n",
+	       (SCHED_ENGINE_PQ == engine) ? "pq" : "wheel",
+	       (unsigned long)n_workers, rate / 1e6, rate / *base,
+	       SchedIsEmpty(sched) ? "" : " (tasks left)");
+
+	SchedDestroy(sched);
+}
+
+static void BenchEngine(sched_engine_t engine, task_spec_t *specs,
+                        size_t n_cores)
+{
+	size_t n_workers = 1;
+	double base = 0;
+
+	for(; n_workers < n_cores; n_workers *= 2)
+	{
+		Bench(engine, specs, n_workers, &base);
+	}
+	Bench(engine, specs, n_cores, &base);
+}
+
+int main(void)
+{
+	task_spec_t *specs = (task_spec_t *)malloc(N_TASKS * sizeof(task_spec_t));
+	long n_cores = sysconf(_SC_NPROCESSORS_ONLN);
+	size_t idx = 0;
+
+	if(NULL == specs)
+	{
+		printf("allocation failed\n");
+		return 1;
+	}
+
+	n_cores = (n_cores < 1) ? 1 : n_cores;
+
+	for(idx = 0; idx < N_TASKS; ++idx)
+	{
+		specs[idx].interval_ns = 0;
+		specs[idx].action = ShortTask;
+		specs[idx].params = NULL;
+	}
+
+	BenchEngine(SCHED_ENGINE_PQ, specs, (size_t)n_cores);
+	BenchEngine(SCHED_ENGINE_WHEEL, specs, (size_t)n_cores);
+
+	free(specs);
+
+	return 0;
+}
@@ -0,0 +1,435 @@
+/********************************************
+File name : sched_test.c
+Author : Omer Avioz
+Reviewer :
+Infinity Labs OL95
+*******************************************/
+
+/* make test */
+
+#define _POSIX_C_SOURCE 200112L	/* nanosleep */
+
+/* 				External Libraries
+-------------------------------------------*/
+
+#include <stdio.h>	/* printf */
+#include <time.h>	/* nanosleep */
+
+#include "sched.h"	/* scheduler API */
+
+#define N_TASKS (2000)
+#define MS (1000000UL)
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if(!(cond)) \
+		{ \
+			printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+			++failures; \
+		} \
+	} \
+	while(0)
+
+typedef struct counter
+{
+	sched_t *sched;
+	size_t runs;
+	size_t left;
+	ilrd_uid_t other;
+	int is_in_action;
+	unsigned long done_ns;
+} counter_t;
+
+static const char *EngineName(sched_engine_t engine)
+{
+	return (SCHED_ENGINE_PQ == engine) ? "pq" : "wheel";
+}
+
+static int CountOnce(void *params)
+{
+	__atomic_fetch_add(&((counter_t *)params)->runs, 1, __ATOMIC_RELAXED);
+
+	return 1;
+}
+
+/* adds the next link of the chain from inside the action */
+static int Chain(void *params)
+{
+	counter_t *counter = (counter_t *)params;
+
+	++counter->runs;
+	if(0 != counter->left)
+	{
+		--counter->left;
+		CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(counter->sched,
+		                                         SchedTimeNs(), 0, Chain,
+		                                         counter)));
+	}
+
+	return 1;
+}
+
+static int RemoveOther(void *params)
+{
+	counter_t *counter = (counter_t *)params;
+
+	++counter->runs;
+	SchedRemoveTask(counter->sched, counter->other);
+
+	return 1;
+}
+
+static int Stop(void *params)
+{
+	counter_t *counter = (counter_t *)params;
+
+	++counter->runs;
+	SchedStop(counter->sched);
+
+	return 1;
+}
+
+static void SleepMs(unsigned long ms)
+{
+	struct timespec time_to_sleep = {0};
+
+	time_to_sleep.tv_nsec = (long)(ms * MS);
+	nanosleep(&time_to_sleep, NULL);
+}
+
+/* periodic, fails if another worker is inside the same task */
+static int Periodic(void *params)
+{
+	counter_t *counter = (counter_t *)params;
+
+	CHECK(0 == __atomic_exchange_n(&counter->is_in_action, 1,
+	                               __ATOMIC_ACQUIRE));
+	SleepMs(1);
+	++counter->runs;
+	__atomic_store_n(&counter->is_in_action, 0, __ATOMIC_RELEASE);
+
+	return (counter->runs == counter->left);
+}
+
+static int Slow(void *params)
+{
+	counter_t *counter = (counter_t *)params;
+
+	SleepMs(300);
+	counter->done_ns = SchedTimeNs();
+
+	return 1;
+}
+
+static int Quick(void *params)
+{
+	counter_t *counter = (counter_t *)params;
+
+	counter->done_ns = SchedTimeNs();
+
+	return 1;
+}
+
+static int Fail(void *params)
+{
+	(void)params;
+
+	return -1;
+}
+
+/* periodic, checks its own stats before it runs for the last time */
+static int CheckOwnStats(void *params)
+{
+	counter_t *counter = (counter_t *)params;
+	sched_task_stats_t stats;
+
+	++counter->runs;
+	SleepMs(2);
+	if(counter->runs < counter->left)
+	{
+		return 0;
+	}
+
+	CHECK(0 == SchedGetTaskStats(counter->sched, counter->other, &stats));
+	CHECK(counter->left - 1 == stats.executions);
+	CHECK(0 == stats.failures);
+	CHECK(2 * MS <= stats.run_time_max_ns);
+	CHECK(stats.run_time_max_ns <= stats.run_time_total_ns);
+
+	return 1;
+}
+
+static int Run(sched_t *sched, size_t n_workers)
+{
+	return (0 == n_workers) ? SchedRun(sched) :
+	                          SchedRunParallel(sched, n_workers);
+}
+
+/* every one shot task runs exactly once, n_workers 0 is SchedRun */
+static void TestOneShot(sched_engine_t engine, size_t n_workers)
+{
+	static counter_t counters[N_TASKS];
+	sched_t *sched = SchedCreateEngine(engine);
+	unsigned long now = SchedTimeNs();
+	size_t i = 0;
+
+	CHECK(NULL != sched);
+	if(NULL == sched)
+	{
+		return;
+	}
+
+	for(i = 0; i < N_TASKS; ++i)
+	{
+		counters[i].runs = 0;
+		CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now + (i % 7) * MS,
+		                                         0, CountOnce,
+		                                         counters + i)));
+	}
+	CHECK(N_TASKS == SchedSize(sched));
+
+	CHECK(0 == Run(sched, n_workers));
+	CHECK(SchedIsEmpty(sched));
+
+	for(i = 0; i < N_TASKS; ++i)
+	{
+		if(1 != counters[i].runs)
+		{
+			printf("%s, %lu workers: task %lu ran %lu times\n",
+			       EngineName(engine), (unsigned long)n_workers,
+			       (unsigned long)i, (unsigned long)counters[i].runs);
+			++failures;
+			break;
+		}
+	}
+
+	SchedDestroy(sched);
+}
+
+/* actions add and remove tasks of the running sched */
+static void TestFromAction(sched_engine_t engine, size_t n_workers)
+{
+	sched_t *sched = SchedCreateEngine(engine);
+	counter_t chain = {0};
+	counter_t remover = {0};
+	counter_t removed = {0};
+	unsigned long now = SchedTimeNs();
+
+	CHECK(NULL != sched);
+	if(NULL == sched)
+	{
+		return;
+	}
+
+	chain.sched = sched;
+	chain.left = 99;
+	CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now, 0, Chain, &chain)));
+
+	remover.sched = sched;
+	remover.other = SchedAddTaskNs(sched, now + 50 * MS, 0, CountOnce,
+	                               &removed);
+	CHECK(!UIDIsSame(BAD_UID, remover.other));
+	CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now, 0, RemoveOther,
+	                                         &remover)));
+
+	CHECK(0 == Run(sched, n_workers));
+	CHECK(100 == chain.runs);
+	CHECK(1 == remover.runs);
+	CHECK(0 == removed.runs);
+	CHECK(SchedIsEmpty(sched));
+
+	SchedDestroy(sched);
+}
+
+/* SchedStop from an action ends the run, tasks that did not start stay */
+static void TestStop(sched_engine_t engine, size_t n_workers)
+{
+	sched_t *sched = SchedCreateEngine(engine);
+	counter_t stopper = {0};
+	counter_t later = {0};
+	ilrd_uid_t later_uid = BAD_UID;
+	unsigned long now = SchedTimeNs();
+
+	CHECK(NULL != sched);
+	if(NULL == sched)
+	{
+		return;
+	}
+
+	stopper.sched = sched;
+	CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now, 0, Stop,
+	                                         &stopper)));
+	later_uid = SchedAddTaskNs(sched, now + 1000 * MS, 0, CountOnce, &later);
+	CHECK(!UIDIsSame(BAD_UID, later_uid));
+
+	CHECK(0 == Run(sched, n_workers));
+	CHECK(1 == stopper.runs);
+	CHECK(0 == later.runs);
+	CHECK(1 == SchedSize(sched));
+
+	SchedRemoveTask(sched, later_uid);
+	CHECK(SchedIsEmpty(sched));
+
+	SchedDestroy(sched);
+}
+
+/* a periodic task is never run by two workers at once, even when its
+   interval is shorter than its run time */
+static void TestPeriodic(sched_engine_t engine, size_t n_workers)
+{
+	sched_t *sched = SchedCreateEngine(engine);
+	counter_t periodic = {0};
+
+	CHECK(NULL != sched);
+	if(NULL == sched)
+	{
+		return;
+	}
+
+	periodic.left = 20;
+	CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, SchedTimeNs(), MS / 10,
+	                                         Periodic, &periodic)));
+
+	CHECK(0 == SchedRunParallel(sched, n_workers));
+	CHECK(20 == periodic.runs);
+	CHECK(SchedIsEmpty(sched));
+
+	SchedDestroy(sched);
+}
+
+/* a slow action keeps one worker busy, the tasks due with it and after it
+   are run by the other worker (or stolen from the slow one's deque) */
+static void TestSlowTask(sched_engine_t engine)
+{
+	static counter_t quick[N_TASKS / 10];
+	sched_t *sched = SchedCreateEngine(engine);
+	counter_t slow = {0};
+	unsigned long now = SchedTimeNs();
+	size_t i = 0;
+
+	CHECK(NULL != sched);
+	if(NULL == sched)
+	{
+		return;
+	}
+
+	CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now, 0, Slow, &slow)));
+	for(i = 0; i < N_TASKS / 10; ++i)
+	{
+		quick[i].done_ns = 0;
+		CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now + (i % 3) * MS,
+		                                         0, Quick, quick + i)));
+	}
+
+	CHECK(0 == SchedRunParallel(sched, 2));
+	CHECK(0 != slow.done_ns);
+	for(i = 0; i < N_TASKS / 10; ++i)
+	{
+		CHECK(0 != quick[i].done_ns && quick[i].done_ns < slow.done_ns);
+	}
+
+	SchedDestroy(sched);
+}
+
+static size_t SumHist(const sched_stats_t *stats)
+{
+	size_t sum = 0;
+	size_t i = 0;
+
+	for(; i < SCHED_LATENESS_BUCKETS; ++i)
+	{
+		sum += stats->lateness_hist[i];
+	}
+
+	return sum;
+}
+
+/* stats count every run while enabled, failures are negative returns, and
+   the counters are kept while disabled */
+static void TestStats(sched_engine_t engine, size_t n_workers)
+{
+	sched_t *sched = SchedCreateEngine(engine);
+	counter_t counters[10];
+	counter_t periodic = {0};
+	sched_stats_t stats;
+	sched_task_stats_t task_stats;
+	unsigned long now = SchedTimeNs();
+	size_t i = 0;
+
+	CHECK(NULL != sched);
+	if(NULL == sched)
+	{
+		return;
+	}
+
+	SchedEnableStats(sched, 1);
+
+	for(i = 0; i < 10; ++i)
+	{
+		counters[i].runs = 0;
+		CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now, 0, CountOnce,
+		                                         counters + i)));
+	}
+	for(i = 0; i < 5; ++i)
+	{
+		CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now, 0, Fail, NULL)));
+	}
+	periodic.sched = sched;
+	periodic.left = 3;
+	periodic.other = SchedAddTaskNs(sched, now, MS, CheckOwnStats, &periodic);
+	CHECK(!UIDIsSame(BAD_UID, periodic.other));
+
+	CHECK(0 == Run(sched, n_workers));
+	CHECK(3 == periodic.runs);
+	CHECK(0 != SchedGetTaskStats(sched, periodic.other, &task_stats));
+
+	SchedGetStats(sched, &stats);
+	CHECK(18 == stats.executions);
+	CHECK(5 == stats.failures);
+	CHECK(18 == SumHist(&stats));
+	CHECK(16 <= stats.queue_high_water);
+	CHECK(2 * MS <= stats.run_time_max_ns);
+	CHECK(6 * MS <= stats.run_time_total_ns);
+
+	/* not counted while disabled, kept for the next enable */
+	SchedEnableStats(sched, 0);
+	CHECK(!UIDIsSame(BAD_UID, SchedAddTaskNs(sched, now, 0, Fail, NULL)));
+	CHECK(0 == Run(sched, n_workers));
+	SchedEnableStats(sched, 1);
+	SchedGetStats(sched, &stats);
+	CHECK(18 == stats.executions);
+	CHECK(5 == stats.failures);
+
+	SchedDestroy(sched);
+}
+
+int main(void)
+{
+	static const size_t workers[] = {0, 1, 2, 4};
+	sched_engine_t engine = SCHED_ENGINE_PQ;
+	size_t i = 0;
+
+	for(; engine <= SCHED_ENGINE_WHEEL; ++engine)
+	{
+		for(i = 0; i < sizeof(workers) / sizeof(workers[0]); ++i)
+		{
+			TestOneShot(engine, workers[i]);
+			TestFromAction(engine, workers[i]);
+			TestStop(engine, workers[i]);
+			TestStats(engine, workers[i]);
+		}
+		TestPeriodic(engine, 1);
+		TestPeriodic(engine, 4);
+		TestSlowTask(engine);
+	}
+
+	if(0 == failures)
+	{
+		printf("sched: all tests passed\n");
+	}
+
+	return (0 != failures);
+}